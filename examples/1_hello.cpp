@@ -23,11 +23,11 @@ int main() {
   seg::addObject("Sphere",
                  new segobj::Mesh(segobj::primitives::Icosphere(0.498, 2)));
 
-  // object without name -> SEG will generate one and return it.
-  std::string name = seg::addObject(
+  // object without name -> displayed by type, reached through its handle.
+  seg::ObjectHandle handle = seg::addObject(
       new segobj::StaticPointcloud(segobj::primitives::GaussianRandomVertices(
           3000, Eigen::Vector3f{10, 0, 0}, 1)));
-  std::cout << "Name : " << name << std::endl;
+  std::cout << "Handle : " << handle.index << std::endl;
 
   // object given through shared pointer ( recommended )
   auto line_renderer = std::make_shared<segobj::StaticLine>(
@@ -0,0 +1,87 @@
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <Eigen/Dense>
+
+#include "seg/seg"
+
+using namespace std::literals::chrono_literals;
+namespace segobj = ::seg::object;
+
+// Upload benchmark for DYNAMIC renderers.
+// Streams 100k-point scans at 20 Hz and reports upload throughput and frame
+// time variance. Run once per policy to compare, e.g.
+//   ./streaming_upload realloc   (legacy glBufferData path)
+//   ./streaming_upload auto      (persistent ring, or orphaning)
+
+const int scan_points = 100000;
+const int scan_rate_hz = 20;
+const int warmup_seconds = 2;
+
+seg::UploadPolicy parsePolicy(const std::string& arg) {
+  if (arg == "realloc") return seg::UploadPolicy::REALLOCATE;
+  if (arg == "orphan") return seg::UploadPolicy::ORPHAN;
+  if (arg == "ring") return seg::UploadPolicy::PERSISTENT_RING;
+  return seg::UploadPolicy::AUTO;
+}
+
+int main(int argc, char** argv) {
+  const std::string policy_name = (argc > 1) ? argv[1] : "auto";
+  const int seconds = (argc > 2) ? std::stoi(argv[2]) : 10;
+
+  seg::Options option;
+  option.verbosity = seg::Verbosity::WARN;
+  option.upload_policy = parsePolicy(policy_name);
+  seg::initialize("Streaming upload benchmark", seg::WindowSize(1000, 600),
+                  option);
+
+  auto scan = std::make_shared<segobj::Pointcloud>();
+  seg::addObject("scan", scan);
+
+  // pre-generated scans, so generation cost stays out of the measurement
+  std::vector<std::vector<Eigen::Vector3f>> scans;
+  for (int i = 0; i < 8; i++)
+    scans.push_back(segobj::primitives::GaussianRandomVertices(
+        scan_points, Eigen::Vector3f(i, 0, 0), 5.0f));
+
+  auto period = std::chrono::microseconds(1000000 / scan_rate_hz);
+  auto next = std::chrono::steady_clock::now();
+  seg::FrameStats begin;
+
+  const int total_scans = (warmup_seconds + seconds) * scan_rate_hz;
+  for (int i = 0; i < total_scans; i++) {
+    if (i == warmup_seconds * scan_rate_hz) begin = seg::getFrameStats();
+
+    scan->setData(scans[i % scans.size()]);
+    next += period;
+    std::this_thread::sleep_until(next);
+  }
+
+  const seg::FrameStats end = seg::getFrameStats();
+  const double megabytes = (end.upload_bytes - begin.upload_bytes) / 1e6;
+  const double upload_seconds =
+      (end.upload_time_ms - begin.upload_time_ms) * 1e-3;
+
+  std::cout << "policy               : " << policy_name << std::endl;
+  std::cout << "frames               : " << end.frame_count - begin.frame_count
+            << std::endl;
+  std::cout << "uploaded             : " << megabytes << " MB" << std::endl;
+  std::cout << "upload throughput    : "
+            << (upload_seconds > 0 ? megabytes / upload_seconds : 0.0)
+            << " MB/s (cpu time in upload calls)" << std::endl;
+  std::cout << "upload stalls        : "
+            << end.upload_stalls - begin.upload_stalls << std::endl;
+  std::cout << "frame time mean      : " << end.frame_time_mean_ms << " ms"
+            << std::endl;
+  std::cout << "frame time stddev    : " << end.frame_time_stddev_ms << " ms"
+            << std::endl;
+
+  seg::shutdown();
+  seg::waitUntilClosed();
+
+  return 0;
+}
@@ -0,0 +1,95 @@
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "seg/seg"
+
+using namespace std::literals::chrono_literals;
+namespace segobj = ::seg::object;
+
+// Object registry benchmark.
+// Adds 100k objects unnamed and named, lets them draw for a while and deletes
+// them again, reporting the cost of each API call and the frame time. Objects
+// are hidden unless "visible" is given, so the frame time is registry
+// overhead rather than draw calls.
+//   ./object_handles [visible]
+
+const int object_count = 100000;
+const int draw_seconds = 3;
+
+double elapsedUs(std::chrono::steady_clock::time_point begin) {
+  return std::chrono::duration<double, std::micro>(
+             std::chrono::steady_clock::now() - begin)
+      .count();
+}
+
+std::vector<std::shared_ptr<segobj::Pose>> makePoses(bool visible) {
+  std::vector<std::shared_ptr<segobj::Pose>> poses;
+  poses.reserve(object_count);
+  for (int i = 0; i < object_count; i++) {
+    Eigen::Matrix4f pose = Eigen::Matrix4f::Identity();
+    pose.block<3, 1>(0, 3) = Eigen::Vector3f(i % 100, i / 100 % 100, i / 10000);
+    poses.push_back(std::make_shared<segobj::Pose>(pose));
+    poses.back()->is_visible = visible;
+  }
+  return poses;
+}
+
+void report(const std::string& what, double us) {
+  std::cout << what << us / 1000.0 << " ms (" << us / object_count
+            << " us per object)" << std::endl;
+}
+
+int main(int argc, char** argv) {
+  const bool visible = (argc > 1) && std::string(argv[1]) == "visible";
+
+  seg::Options option;
+  option.verbosity = seg::Verbosity::WARN;
+  seg::initialize("Object handle benchmark", seg::WindowSize(1000, 600),
+                  option);
+
+  // objects are built up front, so only registry calls are measured
+  auto unnamed = makePoses(visible);
+  auto named = makePoses(visible);
+  std::vector<seg::ObjectHandle> handles;
+  handles.reserve(object_count);
+
+  auto begin = std::chrono::steady_clock::now();
+  for (auto& pose : unnamed) handles.push_back(seg::addObject(pose));
+  report("add unnamed          : ", elapsedUs(begin));
+
+  begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < object_count; i++)
+    seg::addObject("pose" + std::to_string(i), named[i]);
+  report("add named            : ", elapsedUs(begin));
+
+  std::this_thread::sleep_for(1s);  // replayed on the render thread
+  const seg::FrameStats draw_begin = seg::getFrameStats();
+  std::this_thread::sleep_for(std::chrono::seconds(draw_seconds));
+  const seg::FrameStats draw_end = seg::getFrameStats();
+
+  begin = std::chrono::steady_clock::now();
+  for (auto& handle : handles) seg::deleteObject(handle);
+  report("delete by handle     : ", elapsedUs(begin));
+
+  begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < object_count; i++)
+    seg::deleteObject("pose" + std::to_string(i));
+  report("delete by name       : ", elapsedUs(begin));
+
+  std::cout << "frames with " << 2 * object_count
+            << " objects : " << draw_end.frame_count - draw_begin.frame_count
+            << std::endl;
+  std::cout << "frame time mean      : " << draw_end.frame_time_mean_ms
+            << " ms" << std::endl;
+
+  seg::shutdown();
+  seg::waitUntilClosed();
+
+  return 0;
+}
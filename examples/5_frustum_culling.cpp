@@ -0,0 +1,68 @@
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "seg/seg"
+
+namespace segobj = ::seg::object;
+
+// Culling benchmark.
+// Spreads 2500 submaps over 5 km x 5 km and reports how many of them each
+// frame draws / culls, and the frame time. An optional max draw distance
+// (meters) culls far submaps that are still in the frustum.
+//   ./frustum_culling [max_distance]
+
+const int grid_size = 50;  // submaps per side
+const float submap_spacing = 100.0f;
+const int submap_points = 2000;
+const int draw_seconds = 5;
+
+int main(int argc, char** argv) {
+  const float max_distance = (argc > 1) ? std::stof(argv[1]) : 0.0f;
+
+  seg::Options option;
+  option.verbosity = seg::Verbosity::WARN;
+  seg::initialize("Frustum culling benchmark", seg::WindowSize(1000, 600),
+                  option);
+
+  // submaps share one local cloud, placed by their transforms
+  const auto local = segobj::primitives::GaussianRandomVertices(
+      submap_points, Eigen::Vector3f::Zero(), 20.0f);
+
+  seg::Batch batch;
+  for (int i = 0; i < grid_size * grid_size; i++) {
+    auto submap = std::make_shared<segobj::StaticPointcloud>(local);
+    submap->setMaxDrawDistance(max_distance);
+
+    Eigen::Matrix4f pose = Eigen::Matrix4f::Identity();
+    pose.block<3, 1>(0, 3) = Eigen::Vector3f(i % grid_size, i / grid_size, 0) *
+                             submap_spacing;
+    batch.addObject(submap);
+    batch.setTransform(submap, pose);
+  }
+  seg::commit(std::move(batch));
+
+  std::this_thread::sleep_for(std::chrono::seconds(1));
+  const seg::FrameStats begin = seg::getFrameStats();
+  std::this_thread::sleep_for(std::chrono::seconds(draw_seconds));
+  const seg::FrameStats end = seg::getFrameStats();
+
+  std::cout << "submaps drawn        : " << end.objects_drawn << std::endl;
+  std::cout << "submaps culled       : " << end.objects_culled << std::endl;
+  std::cout << "draw calls           : " << end.draw_calls << std::endl;
+  std::cout << "state changes        : " << end.state_changes << std::endl;
+  std::cout << "frames               : " << end.frame_count - begin.frame_count
+            << std::endl;
+  std::cout << "frame time mean      : " << end.frame_time_mean_ms << " ms"
+            << std::endl;
+
+  seg::shutdown();
+  seg::waitUntilClosed();
+
+  return 0;
+}
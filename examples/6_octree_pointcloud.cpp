@@ -0,0 +1,86 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "seg/seg"
+
+namespace segobj = ::seg::object;
+
+// Level of detail benchmark.
+// Builds a rolling terrain of N million points (default 50) with intensity
+// and reports frame time while the octree streams nodes under a point
+// budget. Orbit the camera to watch nodes stream in.
+//   ./octree_pointcloud [million_points] [budget_million]
+
+const float terrain_size = 2000.0f;  // meters
+const int draw_seconds = 10;
+
+std::vector<Eigen::Vector3f> makeTerrain(size_t count,
+                                         std::vector<float>& intensities) {
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<float> xy(-terrain_size / 2,
+                                           terrain_size / 2);
+  std::normal_distribution<float> noise(0.0f, 0.05f);
+
+  std::vector<Eigen::Vector3f> points(count);
+  intensities.resize(count);
+  for (size_t i = 0; i < count; i++) {
+    const float x = xy(gen), y = xy(gen);
+    const float z = 10.0f * std::sin(x * 0.01f) * std::cos(y * 0.013f);
+    points[i] = Eigen::Vector3f(x, y, z + noise(gen));
+    intensities[i] = 127.5f + 127.5f * std::sin(x * 0.1f);
+  }
+  return points;
+}
+
+int main(int argc, char** argv) {
+  const size_t count =
+      static_cast<size_t>((argc > 1) ? std::stod(argv[1]) * 1e6 : 50e6);
+  const size_t budget =
+      static_cast<size_t>((argc > 2) ? std::stod(argv[2]) * 1e6 : 5e6);
+
+  seg::Options option;
+  option.verbosity = seg::Verbosity::INFO;
+  seg::initialize("Octree pointcloud benchmark", seg::WindowSize(1000, 600),
+                  option);
+
+  std::vector<float> intensities;
+  auto begin = std::chrono::steady_clock::now();
+  const auto points = makeTerrain(count, intensities);
+  std::cout << "generated " << count << " points in "
+            << std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                             begin)
+                   .count()
+            << " s" << std::endl;
+
+  auto cloud = std::make_shared<segobj::OctreePointcloud>(
+      points, seg::AttributeView(), intensities);
+  cloud->setPointBudget(budget);
+  seg::addObject("terrain", cloud);
+
+  std::this_thread::sleep_for(std::chrono::seconds(2));
+  const seg::FrameStats draw_begin = seg::getFrameStats();
+  std::this_thread::sleep_for(std::chrono::seconds(draw_seconds));
+  const seg::FrameStats draw_end = seg::getFrameStats();
+
+  std::cout << "frames               : "
+            << draw_end.frame_count - draw_begin.frame_count << std::endl;
+  std::cout << "frame time mean      : " << draw_end.frame_time_mean_ms
+            << " ms" << std::endl;
+  std::cout << "frame time stddev    : " << draw_end.frame_time_stddev_ms
+            << " ms" << std::endl;
+  std::cout << "uploaded             : "
+            << (draw_end.upload_bytes - draw_begin.upload_bytes) / 1048576
+            << " MB" << std::endl;
+
+  seg::waitUntilClosed();
+
+  return 0;
+}
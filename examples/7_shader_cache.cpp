@@ -0,0 +1,46 @@
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#include "seg/seg"
+
+// Startup benchmark.
+// Reports time-to-first-frame and how the shader programs were made. Run it
+// twice: the first run fills the program binary cache (cold), the second
+// loads from it (warm). "clear" empties the cache first, "off" disables it.
+//   ./shader_cache [cache_dir] [clear|off]
+
+int main(int argc, char** argv) {
+  const std::string cache_dir = (argc > 1) ? argv[1] : "/tmp/seg_shaders";
+  const std::string mode = (argc > 2) ? argv[2] : "";
+
+  if (mode == "clear") {
+    std::error_code error;  // a missing cache is already clear
+    std::filesystem::remove_all(cache_dir, error);
+  }
+
+  seg::Options option;
+  option.verbosity = seg::Verbosity::WARN;
+  option.use_shader_cache = (mode != "off");
+  option.shader_cache_dir = cache_dir;
+  seg::initialize("Shader cache benchmark", seg::WindowSize(1000, 600),
+                  option);
+
+  while (seg::getFrameStats().frame_count == 0)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  const seg::FrameStats stats = seg::getFrameStats();
+
+  std::cout << "time to first frame  : " << stats.first_frame_ms << " ms"
+            << std::endl;
+  std::cout << "programs from cache  : " << stats.programs_cached << std::endl;
+  std::cout << "programs compiled    : " << stats.programs_compiled
+            << std::endl;
+
+  seg::shutdown();
+  seg::waitUntilClosed();
+
+  return 0;
+}
@@ -0,0 +1,83 @@
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <Eigen/Dense>
+
+#include "seg/seg"
+
+namespace segobj = ::seg::object;
+
+// Frame pacing benchmark.
+// A producer moves a pose at 1 kHz, like a tracking frontend would. Reports
+// the frame time, latch to present latency and setData to present latency
+// (percentiles) of the chosen pacing.
+//   ./low_latency [vsync | frame_cap] [nosync]
+//   ./low_latency            vsync
+//   ./low_latency 0          low latency, uncapped
+//   ./low_latency 120        low latency, 120 fps cap
+
+const int draw_seconds = 5;
+
+int main(int argc, char** argv) {
+  const std::string pacing = (argc > 1) ? argv[1] : "vsync";
+  const bool gpu_sync = !((argc > 2) && std::string(argv[2]) == "nosync");
+
+  seg::Options option;
+  option.verbosity = seg::Verbosity::WARN;
+  if (pacing != "vsync") {
+    option.frame_pacing = seg::FramePacing::LOW_LATENCY;
+    option.frame_cap = std::stoi(pacing);
+    option.gpu_sync = gpu_sync;
+  }
+  seg::initialize("Low latency benchmark", seg::WindowSize(1000, 600),
+                  option);
+
+  auto pose = std::make_shared<segobj::Pose>();
+  const seg::ObjectHandle handle = seg::addObject(pose);
+
+  std::atomic<bool> stop{false};
+  std::thread producer([&] {
+    const auto begin = std::chrono::steady_clock::now();
+    while (!stop) {
+      const float t = std::chrono::duration<float>(
+                          std::chrono::steady_clock::now() - begin)
+                          .count();
+      Eigen::Matrix4f matrix = Eigen::Matrix4f::Identity();
+      matrix.block<3, 1>(0, 3) =
+          Eigen::Vector3f(std::cos(t) * 3.0f, std::sin(t) * 3.0f, 0.0f);
+      pose->setData(matrix);
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+
+  std::this_thread::sleep_for(std::chrono::seconds(1));
+  const seg::FrameStats begin = seg::getFrameStats();
+  std::this_thread::sleep_for(std::chrono::seconds(draw_seconds));
+  const seg::FrameStats end = seg::getFrameStats();
+
+  stop = true;
+  producer.join();
+
+  std::cout << "pacing               : " << pacing
+            << (gpu_sync ? "" : ", no gpu sync") << std::endl;
+  std::cout << "frames               : " << end.frame_count - begin.frame_count
+            << std::endl;
+  std::cout << "frame time mean      : " << end.frame_time_mean_ms << " ms"
+            << std::endl;
+  std::cout << "latch to present mean: " << end.latency_mean_ms << " ms"
+            << std::endl;
+
+  const seg::LatencyPercentiles data = seg::getDataLatency(handle).to_present;
+  std::cout << "setData to present   : p50 " << data.p50_ms << " / p95 "
+            << data.p95_ms << " / p99 " << data.p99_ms << " ms" << std::endl;
+
+  seg::shutdown();
+  seg::waitUntilClosed();
+
+  return 0;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <Eigen/Dense>
+
+namespace seg {
+/**
+ * Non owning, strided view over float / double attributes in caller memory.
+ * An element is 3 components for vertices / colors, 1 for scalars, and
+ * elements are stride bytes apart, so interleaved structs need no copy.
+ *
+ * e.g. pcl::PointCloud<pcl::PointXYZI> cloud
+ *   AttributeView(&cloud[0].x, cloud.size(), sizeof(pcl::PointXYZI))
+ *   AttributeView(&cloud[0].intensity, cloud.size(), sizeof(pcl::PointXYZI))
+ */
+struct AttributeView {
+  enum class Type { FLOAT, DOUBLE };
+
+  const void* data = nullptr;
+  size_t count = 0;
+  size_t stride = 0;  // bytes from one element to the next
+  Type type = Type::FLOAT;
+
+  AttributeView() {}
+  AttributeView(const float* _data, size_t _count, size_t _stride)
+      : data(_data), count(_count), stride(_stride), type(Type::FLOAT) {}
+  AttributeView(const double* _data, size_t _count, size_t _stride)
+      : data(_data), count(_count), stride(_stride), type(Type::DOUBLE) {}
+
+  AttributeView(const std::vector<Eigen::Vector3f>& vertices)
+      : AttributeView(reinterpret_cast<const float*>(vertices.data()),
+                      vertices.size(),
+                      sizeof(Eigen::Vector3f)) {}
+  AttributeView(const std::vector<Eigen::Vector3d>& vertices)
+      : AttributeView(reinterpret_cast<const double*>(vertices.data()),
+                      vertices.size(),
+                      sizeof(Eigen::Vector3d)) {}
+  AttributeView(const std::vector<float>& scalars)
+      : AttributeView(scalars.data(), scalars.size(), sizeof(float)) {}
+  AttributeView(const std::vector<double>& scalars)
+      : AttributeView(scalars.data(), scalars.size(), sizeof(double)) {}
+
+  // column major 3 x N, one element per column.
+  AttributeView(const Eigen::Matrix3Xf& vertices)
+      : AttributeView(vertices.data(), vertices.cols(), 3 * sizeof(float)) {}
+  AttributeView(const Eigen::Matrix3Xd& vertices)
+      : AttributeView(vertices.data(), vertices.cols(), 3 * sizeof(double)) {}
+
+  bool empty() const { return count == 0; }
+};
+}  // namespace seg
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "seg/types.h"
+
+namespace seg {
+namespace object {
+class ObjectBase;
+class ObjectManager;
+}  // namespace object
+
+/**
+ * Changes to many objects, applied together at one frame boundary by
+ * seg::commit(). Staging takes no locks; a batch is filled by one thread at
+ * a time and may be committed from any thread.
+ *
+ * e.g. one SLAM step
+ *   seg::Batch batch;
+ *   batch.addObject("landmark42", landmark);
+ *   batch.update([scan, points = std::move(points)]() mutable {
+ *     scan->setData(std::move(points));
+ *   });
+ *   batch.setTransform(scan, T_world_sensor);
+ *   seg::commit(std::move(batch));
+ */
+class Batch {
+ public:
+  // see seg::addObject(); the handle is returned by seg::commit().
+  void addObject(const std::string& name,
+                 const std::shared_ptr<object::ObjectBase>& object) {
+    Op op(Op::Type::ADD);
+    op.name = name;
+    op.object = object;
+    ops.push_back(std::move(op));
+  }
+  void addObject(const std::shared_ptr<object::ObjectBase>& object) {
+    addObject("", object);
+  }
+
+  void deleteObject(ObjectHandle handle) {
+    Op op(Op::Type::DELETE);
+    op.handle = handle;
+    ops.push_back(std::move(op));
+  }
+  void deleteObject(const std::string& name) {
+    Op op(Op::Type::DELETE);
+    op.name = name;
+    ops.push_back(std::move(op));
+  }
+
+  /**
+   * @brief fn runs on the render thread right before the frame showing the
+   *        batch, e.g.
+   *          [cloud, points = std::move(points)]() mutable {
+   *            cloud->setData(std::move(points));
+   *          }
+   *        so its work, e.g. packing the vertices of setData(), delays that
+   *        frame. Keep it short; large or frequent data is better set
+   *        directly, setData() packs on the calling thread.
+   */
+  void update(std::function<void()> fn) {
+    Op op(Op::Type::UPDATE);
+    op.update = std::move(fn);
+    ops.push_back(std::move(op));
+  }
+
+  // model matrix of a gl object.
+  void setTransform(const std::shared_ptr<object::ObjectBase>& object,
+                    const Eigen::Matrix4f& transform) {
+    Op op(Op::Type::TRANSFORM);
+    op.object = object;
+    op.transform = transform;
+    ops.push_back(std::move(op));
+  }
+  void setTransform(ObjectHandle handle, const Eigen::Matrix4f& transform) {
+    Op op(Op::Type::TRANSFORM);
+    op.handle = handle;
+    op.transform = transform;
+    ops.push_back(std::move(op));
+  }
+  template <typename Target>
+  void setTransform(const Target& target, const Eigen::Isometry3f& transform) {
+    setTransform(target, Eigen::Matrix4f(transform.matrix()));
+  }
+
+  bool empty() const { return ops.empty(); }
+  size_t size() const { return ops.size(); }
+
+ private:
+  friend class object::ObjectManager;
+
+  struct Op {
+    enum class Type { ADD, DELETE, UPDATE, TRANSFORM };
+
+    explicit Op(Type _type) : type(_type) {}
+
+    Type type;
+    std::string name;
+    ObjectHandle handle;
+    std::shared_ptr<object::ObjectBase> object;
+    std::function<void()> update;
+    Eigen::Matrix4f transform = Eigen::Matrix4f::Identity();
+  };
+
+  std::vector<Op> ops;
+
+};  // class Batch
+}  // namespace seg
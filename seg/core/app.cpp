@@ -14,7 +14,12 @@
 #include <imgui_impl_opengl3.h>
 
 #include "seg/core/config.h"
+#include "seg/core/frame_request.h"
 #include "seg/core/object_manager.h"
+#include "seg/core/profiler.h"
+#include "seg/core/stats.h"
+#include "seg/gl/program_cache.h"
+#include "seg/gl/render_state.h"
 #include "seg/gl/scene.h"
 #include "seg/resources/roboto_regular.h"
 #include "seg/types.h"
@@ -25,6 +30,36 @@ namespace {
 void glfwErorrCallback(int error, const char* description) {
   LOG_ERROR("GLFW Error {} : {}", error, std::string(description));
 }
+
+// blocks until the gpu finished everything submitted, the last frame too.
+void waitForGpu() {
+  const GLuint64 timeout = 100000000;  // ns
+  GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+  glDeleteSync(fence);
+}
+
+// input may change the ui or move the camera. imgui chains these.
+void setWakeCallbacks(GLFWwindow* window) {
+  using seg::FrameRequest;
+  glfwSetCursorPosCallback(
+      window, [](GLFWwindow*, double, double) { FrameRequest::request(); });
+  glfwSetMouseButtonCallback(
+      window, [](GLFWwindow*, int, int, int) { FrameRequest::request(); });
+  glfwSetScrollCallback(
+      window, [](GLFWwindow*, double, double) { FrameRequest::request(); });
+  glfwSetKeyCallback(window, [](GLFWwindow*, int, int, int, int) {
+    FrameRequest::request();
+  });
+  glfwSetCharCallback(
+      window, [](GLFWwindow*, unsigned int) { FrameRequest::request(); });
+  glfwSetWindowFocusCallback(
+      window, [](GLFWwindow*, int) { FrameRequest::request(); });
+  glfwSetCursorEnterCallback(
+      window, [](GLFWwindow*, int) { FrameRequest::request(); });
+  glfwSetWindowRefreshCallback(
+      window, [](GLFWwindow*) { FrameRequest::request(); });
+}
 }  // namespace
 
 namespace seg {
@@ -53,6 +88,7 @@ void App::initialize(const std::string& _window_name,
 
 void App::requestShutdown() {
   turn_off_requested.store(true);
+  FrameRequest::request();  // wakes an idle loop
 }
 
 void App::waitUntilClosed() {
@@ -61,6 +97,7 @@ void App::waitUntilClosed() {
 
 void App::appMain() {
   running = true;
+  core::Stats::getInstance().markStart();
   windowSetup();
   if (!window) {
     initialized = true;
@@ -72,6 +109,9 @@ void App::appMain() {
   initialized = true;
 
   while (!glfwWindowShouldClose(window) && !turn_off_requested.load()) {
+    if (getConfig().render_mode == RenderMode::ON_DEMAND &&
+        waitForFrame() == false)
+      continue;
     draw();
   }
 
@@ -100,7 +140,7 @@ void App::windowSetup() {
     return;
   }
   glfwMakeContextCurrent(window);
-  glfwSwapInterval(1);  // vsync
+  glfwSwapInterval(swap_interval);  // vsync, off for LOW_LATENCY
 
   // GLEW
   if (glewInit() != GLEW_OK) throw std::runtime_error("GLEW init failed!");
@@ -125,6 +165,7 @@ void App::windowSetup() {
     ImGui::StyleColorsLight();
   else
     ImGui::StyleColorsDark();
+  setWakeCallbacks(window);  // before imgui, which chains them
   ImGui_ImplGlfw_InitForOpenGL(window, true);
   ImGui_ImplOpenGL3_Init(glsl_version);
 }
@@ -136,11 +177,45 @@ void App::initializeComponents() {
   if (scene == nullptr) throw std::runtime_error("Scene is not set!");
 
   scene->init(window);
+  const gl::ProgramCache& program_cache = gl::ProgramCache::getInstance();
+  core::Stats::getInstance().setProgramCounts(program_cache.hits(),
+                                              program_cache.misses());
   object_manager->setShader(&scene->general_shader);
+  object_manager->setView(&scene->view);
   controller->init(scene.get(), object_manager.get());
 }
 
+bool App::waitForFrame() {
+  // imgui shows the effect of input a frame or two later (hover, clicks)
+  if (settle_frames > 0) {
+    settle_frames--;
+    return true;
+  }
+
+  FrameRequest::beginWait();
+  bool requested = FrameRequest::consume();
+  if (requested == false) {
+    glfwWaitEventsTimeout(IDLE_TIMEOUT);
+    requested = FrameRequest::consume();
+  }
+  FrameRequest::endWait();
+
+  if (requested) settle_frames = SETTLE_FRAMES;
+  return requested;
+}
+
 void App::draw() {
+  const core::Config& config = getConfig();
+  const bool low_latency = config.frame_pacing == FramePacing::LOW_LATENCY;
+  if (swap_interval != (low_latency ? 0 : 1)) {
+    swap_interval = low_latency ? 0 : 1;
+    glfwSwapInterval(swap_interval);
+  }
+
+  core::Profiler& profiler = core::Profiler::getInstance();
+  profiler.beginFrame();
+  profiler.beginPhase(core::Profiler::PHASE_UI);
+
   // set frames
   glfwPollEvents();
   ImGui_ImplOpenGL3_NewFrame();
@@ -169,14 +244,37 @@ void App::draw() {
                                  controller->viewport_size.height);
   }
 
+  // object data is latched from here on (queued commands, then mailboxes as
+  // objects draw), as late as the frame cap allows.
+  profiler.beginPhase(core::Profiler::PHASE_WAIT);
+  if (low_latency) frame_pacer.waitToLatch(config.frame_cap);
+  const auto latch = core::FramePacer::Clock::now();
+
+  // imgui drew in between, its state is unknown.
+  gl::RenderState& state = gl::RenderState::getInstance();
+  profiler.beginPhase(core::Profiler::PHASE_SCENE);
+  state.beginFrame();
   scene->draw();
+  profiler.beginPhase(core::Profiler::PHASE_OBJECTS);
   object_manager->draw();
+  core::Stats::getInstance().setRenderCounts(state.drawCalls(),
+                                             state.stateChanges());
 
   // draw imgui render data onto gl buffer
+  profiler.beginPhase(core::Profiler::PHASE_IMGUI);
   ImGui::Render();
   ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
+  profiler.beginPhase(core::Profiler::PHASE_SWAP);
   glfwSwapBuffers(window);
+  if (low_latency && config.gpu_sync) waitForGpu();  // no queued frames
+  profiler.endFrame();
+
+  const auto present = core::FramePacer::Clock::now();
+  frame_pacer.onPresented(latch, present);
+  object_manager->glPresented(present);
+  core::Stats::getInstance().onFrameSwapped(
+      std::chrono::duration<double>(present - latch).count());
 }
 
 void App::shutdown() {
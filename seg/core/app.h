@@ -4,6 +4,7 @@
 #include <memory>
 #include <thread>
 
+#include "seg/core/frame_pacer.h"
 #include "seg/options.h"
 #include "seg/types.h"
 
@@ -58,8 +59,18 @@ class App {
   std::atomic<bool> initialized{false};
   std::atomic<bool> running{false};
 
+  // RenderMode::ON_DEMAND
+  static constexpr double IDLE_TIMEOUT = 0.5;  // seconds, to see shutdown
+  static const int SETTLE_FRAMES = 2;  // after a requested one, for imgui
+  int settle_frames = 0;
+
+  core::FramePacer frame_pacer;  // FramePacing::LOW_LATENCY
+  int swap_interval = 1;
+
   void windowSetup();
   void initializeComponents();
+  // ON_DEMAND: sleeps until a frame is requested, false on timeout.
+  bool waitForFrame();
   void draw();
   void shutdown();
 
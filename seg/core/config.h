@@ -15,10 +15,22 @@ class Config {
   float camera_distance = 10.0f;  // meter
 
   bool show_fps = true;
+  bool show_render_stats = false;  // draw calls / state changes, with fps
   bool show_grid = true;
   bool show_origin = true;
+  bool show_profiler = false;
+  float frame_budget_ms = 33.3f;  // profiler, slower frames are hitches
 
-  std::string selected_object_name = "";
+  UploadPolicy upload_policy = UploadPolicy::AUTO;
+  RenderMode render_mode = RenderMode::CONTINUOUS;
+  FramePacing frame_pacing = FramePacing::VSYNC;
+  int frame_cap = 0;  // fps, 0 - uncapped
+  bool gpu_sync = true;
+
+  bool use_shader_cache = true;
+  std::string shader_cache_dir;  // empty: default location (see Options)
+
+  ObjectHandle selected_object;
 
  private:
   Config() {};
@@ -0,0 +1,74 @@
+#include "seg/core/data_latency.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <vector>
+
+#include "seg/core/stats.h"
+
+namespace seg {
+namespace core {
+LatencyPercentiles percentiles(std::vector<float>& samples) {
+  LatencyPercentiles out;
+  if (samples.empty()) return out;
+
+  auto at = [&samples](double p) {
+    const size_t rank = static_cast<size_t>(
+        std::ceil(p * static_cast<double>(samples.size()))) - 1;
+    std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+    return static_cast<double>(samples[rank]);
+  };
+  out.p50_ms = at(0.50);
+  out.p95_ms = at(0.95);
+  out.p99_ms = at(0.99);
+  return out;
+}
+
+bool DataLatency::glLatch() {
+  changed = pending.exchange(0);
+  if (changed == 0) return false;
+
+  latched = now();
+  return true;
+}
+
+void DataLatency::glPresented(Clock::time_point present) {
+  if (changed == 0) return;
+
+  const int64_t present_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          present.time_since_epoch())
+          .count();
+  const float upload_ms = (latched - changed) * 1e-6f;
+  const float present_ms = (present_ns - changed) * 1e-6f;
+  changed = 0;
+
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    to_upload[count % HISTORY] = upload_ms;
+    to_present[count % HISTORY] = present_ms;
+    count++;
+  }
+  Stats::getInstance().addDataLatency(upload_ms, present_ms);
+}
+
+DataLatencyStats DataLatency::snapshot() {
+  DataLatencyStats out;
+  std::vector<float> upload, present;
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    out.count = count;
+    const size_t samples = std::min<uint64_t>(count, HISTORY);
+    upload.assign(to_upload.begin(), to_upload.begin() + samples);
+    present.assign(to_present.begin(), to_present.begin() + samples);
+  }
+
+  out.to_upload = percentiles(upload);
+  out.to_present = percentiles(present);
+  return out;
+}
+
+}  // namespace core
+}  // namespace seg
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "seg/stats.h"
+
+namespace seg {
+namespace core {
+// percentiles of samples (ms), which it reorders.
+LatencyPercentiles percentiles(std::vector<float>& samples);
+
+/**
+ * How long changes to one object take to reach the screen.
+ * Producers stamp() every change; the oldest change not yet taken by the
+ * render thread is kept, so a burst is measured from its first change.
+ * The render thread latches the stamp right before it takes the object's
+ * data, and completes it once that frame is presented.
+ */
+class DataLatency {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  // any thread, after the change is published.
+  void stamp() {
+    if (pending.load(std::memory_order_relaxed) != 0) return;
+    int64_t expected = 0;
+    pending.compare_exchange_strong(expected, now());
+  }
+
+  // gl thread ======================================================
+  // before the object takes its data. false if nothing changed.
+  bool glLatch();
+  // the frame of the last glLatch() is on screen.
+  void glPresented(Clock::time_point present);
+
+  // any thread
+  DataLatencyStats snapshot();
+
+ private:
+  static const int HISTORY = 256;
+
+  static int64_t now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               Clock::now().time_since_epoch())
+        .count();
+  }
+
+  std::atomic<int64_t> pending{0};  // ns, 0 - none
+  int64_t changed = 0;              // ns, gl thread
+  int64_t latched = 0;
+
+  std::mutex mtx;
+  uint64_t count = 0;
+  std::array<float, HISTORY> to_upload{};  // ms
+  std::array<float, HISTORY> to_present{};
+
+};  // class DataLatency
+}  // namespace core
+}  // namespace seg
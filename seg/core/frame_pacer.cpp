@@ -0,0 +1,34 @@
+#include "seg/core/frame_pacer.h"
+
+#include <chrono>
+#include <thread>
+
+namespace seg {
+namespace core {
+void FramePacer::waitToLatch(int frame_cap) {
+  if (frame_cap <= 0) return;
+
+  const auto now = Clock::now();
+  const auto period = std::chrono::duration<double>(1.0 / frame_cap);
+  const auto budget = std::chrono::duration<double>(latch_to_present *
+                                                    LATCH_MARGIN);
+
+  // a frame behind schedule latches right away, it does not catch up.
+  const auto latch_at =
+      last_present +
+      std::chrono::duration_cast<Clock::duration>(period - budget);
+  if (latch_at > now) std::this_thread::sleep_until(latch_at);
+}
+
+void FramePacer::onPresented(Clock::time_point latch,
+                             Clock::time_point present) {
+  const double elapsed = std::chrono::duration<double>(present - latch).count();
+  latch_to_present = (latch_to_present == 0.0)
+                         ? elapsed
+                         : latch_to_present +
+                               SMOOTHING * (elapsed - latch_to_present);
+  last_present = present;
+}
+
+}  // namespace core
+}  // namespace seg
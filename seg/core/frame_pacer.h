@@ -0,0 +1,35 @@
+#pragma once
+
+#include <chrono>
+
+namespace seg {
+namespace core {
+/**
+ * Frame pacing of FramePacing::LOW_LATENCY. Holds a frame back before it
+ * latches object data, so the latch is as late as the frame cap allows
+ * while the frame still presents on time. How long a frame takes from latch
+ * to present is learned from the previous ones.
+ * gl thread only.
+ */
+class FramePacer {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  // sleeps until the latch of a frame presenting 1 / frame_cap after the
+  // last one. frame_cap 0 - uncapped, no wait.
+  void waitToLatch(int frame_cap);
+  void onPresented(Clock::time_point latch, Clock::time_point present);
+
+  // moving average, seconds
+  double latchToPresent() const { return latch_to_present; }
+
+ private:
+  static constexpr double LATCH_MARGIN = 1.5;  // of latch_to_present
+  static constexpr double SMOOTHING = 0.1;
+
+  Clock::time_point last_present;
+  double latch_to_present = 0.0;
+
+};  // class FramePacer
+}  // namespace core
+}  // namespace seg
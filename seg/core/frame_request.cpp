@@ -0,0 +1,18 @@
+#include "seg/core/frame_request.h"
+
+#include <atomic>
+
+#include <GLFW/glfw3.h>
+
+namespace seg {
+std::atomic<bool> FrameRequest::pending{true};  // the first frame
+std::atomic<bool> FrameRequest::waiting{false};
+
+void FrameRequest::request() {
+  // pending before waiting: a loop that starts waiting after the check has
+  // not checked pending yet, so either way the frame is drawn.
+  if (pending.exchange(true)) return;  // already on its way
+  if (waiting.load()) glfwPostEmptyEvent();
+}
+
+}  // namespace seg
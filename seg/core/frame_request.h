@@ -0,0 +1,29 @@
+#pragma once
+
+#include <atomic>
+
+namespace seg {
+/**
+ * Wakes the render loop in RenderMode::ON_DEMAND. Anything changing what
+ * the next frame shows (object data, transforms, visibility, objects added
+ * or removed, input) calls request(), from any thread. The loop draws a
+ * frame when one is pending and sleeps otherwise.
+ */
+class FrameRequest {
+ public:
+  static void request();
+
+  // gl thread ======================================================
+  // true if a frame was requested since the last call.
+  static bool consume() { return pending.exchange(false); }
+
+  // around the loop's sleep, so request() only posts an event then.
+  static void beginWait() { waiting.store(true); }
+  static void endWait() { waiting.store(false); }
+
+ private:
+  static std::atomic<bool> pending;
+  static std::atomic<bool> waiting;
+
+};  // class FrameRequest
+}  // namespace seg
@@ -1,141 +1,444 @@
 #include "seg/core/object_manager.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <string>
-#include <unordered_map>
+#include <typeinfo>
+#include <utility>
 
+#include <Eigen/Dense>
+
+#include "seg/core/config.h"
+#include "seg/core/frame_request.h"
+#include "seg/core/profiler.h"
+#include "seg/core/stats.h"
+#include "seg/gl/geometry_cache.h"
 #include "seg/gl/shader.h"
+#include "seg/gl/vertex_layout.h"
 #include "seg/object/gl_object.h"
 #include "seg/object/object_base.h"
 #include "seg/internal/logger.h"
 
 namespace seg {
 namespace object {
+namespace {
+/**
+ * Rotation, translation and uniform scale of a similarity transform. false
+ * for anything else (shear, non uniform scale, mirroring, projection), which
+ * instance attributes can not express.
+ */
+bool toInstanceAttributes(const Eigen::Matrix4f& transform,
+                          const RGBA& color,
+                          gl::InstanceAttributes& out) {
+  if ((transform.row(3) - Eigen::RowVector4f(0, 0, 0, 1)).isZero(1e-6f) ==
+      false)
+    return false;
+
+  const Eigen::Matrix3f linear = transform.block<3, 3>(0, 0);
+  const float scale = linear.col(0).norm();
+  if (scale <= 0.0f) return false;
+
+  const Eigen::Matrix3f rotation = linear / scale;
+  if ((rotation.transpose() * rotation).isIdentity(1e-4f) == false ||
+      rotation.determinant() < 0.0f)
+    return false;
+
+  const Eigen::Vector4f q = Eigen::Quaternionf(rotation).normalized().coeffs();
+  for (int i = 0; i < 4; i++) out.rotation[i] = q[i];
+  for (int i = 0; i < 3; i++) out.translation[i] = transform(i, 3);
+  out.translation[3] = scale;
+  out.color[0] = color.r;
+  out.color[1] = color.g;
+  out.color[2] = color.b;
+  out.color[3] = color.a;
+  return true;
+}
+}  // namespace
+
 ObjectManager::~ObjectManager() {
-  std::lock_guard<std::mutex> lock(mtx_object);
   shut_down = true;
-
-  for (auto&& [_, object] : objects) {
-    if (object->getObjectLayer() != ObjectLayer::GL) continue;
-    static_cast<GLObject*>(object.get())->glFree();
+  {
+    std::lock_guard<std::mutex> lock(api_mtx);  // waits out a running add
+    api_objects.clear();
+    names.clear();
   }
 
-  for (auto&& object : objects_to_delete) {
-    if (object->getObjectLayer() != ObjectLayer::GL) continue;
-    static_cast<GLObject*>(object.get())->glFree();
+  glApplyCommands();
+  for (auto& entry : objects) {
+    if (entry.object->getObjectLayer() != ObjectLayer::GL) continue;
+    static_cast<GLObject*>(entry.object.get())->glFree();
   }
-  objects_to_delete.clear();
+
+  for (auto& group : instance_groups)
+    if (group.second.buffer) group.second.buffer->free();
+  gl::GeometryCache::getInstance().glClear();
 }
 
 void ObjectManager::setShader(gl::Shader* _shader) {
-  std::lock_guard<std::mutex> lock(mtx_object);
   shader = _shader;
-  for (auto& [name, obj] : objects) {
-    if (obj->getObjectLayer() == ObjectLayer::GL)
-      static_cast<GLObject*>(obj.get())->setShader(shader);
+  for (auto& entry : objects) {
+    if (entry.object->getObjectLayer() == ObjectLayer::GL)
+      static_cast<GLObject*>(entry.object.get())->setShader(shader);
   }
 }
 
-std::string ObjectManager::addObject(ObjectBase* obj) {
-  return insertObject(std::shared_ptr<ObjectBase>(obj));
+void ObjectManager::setView(const gl::View* _view) {
+  view = _view;
+  for (auto& entry : objects) {
+    if (entry.object->getObjectLayer() == ObjectLayer::GL)
+      static_cast<GLObject*>(entry.object.get())->setView(view);
+  }
 }
 
-std::string ObjectManager::addObject(const std::shared_ptr<ObjectBase>& obj) {
-  return insertObject(obj);
-}
+ObjectHandle ObjectManager::addObject(const std::shared_ptr<ObjectBase>& obj,
+                                      const std::string& name) {
+  std::lock_guard<std::mutex> lock(api_mtx);
 
-void ObjectManager::addObject(const std::string& name, ObjectBase* obj) {
-  insertObject(std::shared_ptr<ObjectBase>(obj), name);
+  Command command;
+  const ObjectHandle handle = addObjectLocked(obj, name, command);
+  // pushed under api_mtx, so the gl thread replays in api order.
+  if (handle.valid()) pushCommand(std::move(command));
+  return handle;
 }
 
-void ObjectManager::addObject(const std::string& name,
-                              const std::shared_ptr<ObjectBase>& obj) {
-  insertObject(obj, name);
+void ObjectManager::pushCommand(Command&& command) {
+  commands.push(std::move(command));
+  FrameRequest::request();  // applied by the next draw()
 }
 
-std::string ObjectManager::insertObject(const std::shared_ptr<ObjectBase>& obj,
-                                        const std::string& _name) {
-  std::lock_guard<std::mutex> lock(mtx_object);
-  if (shut_down) return "";
+ObjectHandle ObjectManager::addObjectLocked(
+    const std::shared_ptr<ObjectBase>& obj,
+    const std::string& name,
+    Command& command) {
+  if (shut_down) return ObjectHandle();
 
-  std::string name = _name.empty() ? generateName(obj.get()) : _name;
-
-  if (objects.find(name) != objects.end()) {
+  if (name.empty() == false && names.find(name) != names.end()) {
     LOG_WARN("objectManager - [{}] already exists !", name);
     LOG_WARN("Add Object fail.");
-    return "";
+    return ObjectHandle();
   }
 
-  if (obj->getObjectLayer() == ObjectLayer::GL && shader)
-    static_cast<GLObject*>(obj.get())->setShader(shader);
+  const ObjectHandle handle = api_objects.insert(Entry{obj, name});
+  Entry& entry = *api_objects.find(handle);
+  if (name.empty())
+    entry.name = obj->getType() + " #" + std::to_string(handle.index);
+  else
+    names[name] = handle;
 
-  objects[name] = obj;
+  command.type = Command::Type::ADD;
+  command.handle = handle;
+  command.entry = entry;
 
-  LOG_INFO("Object '{}({})' added. Total: {}", name, obj->getType(),
-           objects.size());
-  return name;
+  LOG_INFO("Object '{}({})' added. Total: {}", entry.name, obj->getType(),
+           api_objects.size());
+  return handle;
+}
+
+std::weak_ptr<ObjectBase> ObjectManager::getObject(ObjectHandle handle) {
+  std::lock_guard<std::mutex> lock(api_mtx);
+
+  Entry* entry = api_objects.find(handle);
+  if (entry == nullptr) return {};
+
+  return entry->object;
 }
 
 std::weak_ptr<ObjectBase> ObjectManager::getObject(const std::string& name) {
-  std::lock_guard<std::mutex> lock(mtx_object);
+  std::lock_guard<std::mutex> lock(api_mtx);
+
+  auto name_iter = names.find(name);
+  if (name_iter == names.end()) return {};
 
-  auto obj_iter = objects.find(name);
-  if (obj_iter == objects.end()) return {};
+  return api_objects.find(name_iter->second)->object;
+}
+
+bool ObjectManager::deleteObject(ObjectHandle handle) {
+  std::lock_guard<std::mutex> lock(api_mtx);
 
-  return obj_iter->second;
+  Command command;
+  if (deleteObjectLocked(handle, command) == false) return false;
+  pushCommand(std::move(command));
+  return true;
 }
 
 bool ObjectManager::deleteObject(const std::string& name) {
-  std::lock_guard<std::mutex> lock(mtx_object);
+  std::lock_guard<std::mutex> lock(api_mtx);
+
+  auto name_iter = names.find(name);
+  if (name_iter == names.end()) return false;
+
+  Command command;
+  if (deleteObjectLocked(name_iter->second, command) == false) return false;
+  pushCommand(std::move(command));
+  return true;
+}
+
+bool ObjectManager::deleteObjectLocked(ObjectHandle handle, Command& command) {
   if (shut_down) return false;
 
-  auto obj_iter = objects.find(name);
-  if (obj_iter == objects.end()) return false;
+  Entry* entry = api_objects.find(handle);
+  if (entry == nullptr) return false;
 
-  objects_to_delete.push_back(obj_iter->second);
-  objects.erase(name);
+  auto name_iter = names.find(entry->name);
+  if (name_iter != names.end() && name_iter->second == handle)
+    names.erase(name_iter);
+  api_objects.erase(handle);
 
+  // gl resources are freed on the gl thread when the command is applied.
+  command.type = Command::Type::DELETE;
+  command.handle = handle;
   return true;
 }
 
 void ObjectManager::clearObjects() {
-  std::lock_guard<std::mutex> lock(mtx_object);
+  std::lock_guard<std::mutex> lock(api_mtx);
+
+  api_objects.clear();
+  names.clear();
 
-  for (auto&& [_, object] : objects) objects_to_delete.push_back(object);
+  Command command;
+  command.type = Command::Type::CLEAR;
+  pushCommand(std::move(command));
+}
+
+std::vector<ObjectHandle> ObjectManager::commit(Batch&& batch) {
+  std::vector<ObjectHandle> added;
+  Command command;
+  command.type = Command::Type::BATCH;
+  command.batch.reserve(batch.ops.size());
+
+  std::lock_guard<std::mutex> lock(api_mtx);
+  if (shut_down) return added;
+
+  for (auto& op : batch.ops) {
+    Command sub;
+    switch (op.type) {
+      case Batch::Op::Type::ADD: {
+        const ObjectHandle handle = addObjectLocked(op.object, op.name, sub);
+        added.push_back(handle);
+        if (handle.valid() == false) continue;
+        break;
+      }
+      case Batch::Op::Type::DELETE: {
+        ObjectHandle handle = op.handle;
+        if (op.name.empty() == false) {
+          auto name_iter = names.find(op.name);
+          if (name_iter == names.end()) continue;
+          handle = name_iter->second;
+        }
+        if (deleteObjectLocked(handle, sub) == false) continue;
+        break;
+      }
+      case Batch::Op::Type::UPDATE:
+        sub.type = Command::Type::UPDATE;
+        sub.update = std::move(op.update);
+        break;
+      case Batch::Op::Type::TRANSFORM:
+        sub.type = Command::Type::TRANSFORM;
+        sub.entry.object = std::move(op.object);
+        if (sub.entry.object == nullptr) {
+          Entry* entry = api_objects.find(op.handle);
+          if (entry == nullptr) continue;
+          sub.entry.object = entry->object;
+        }
+        sub.transform = op.transform;
+        break;
+    }
+    command.batch.push_back(std::move(sub));
+  }
 
-  objects.clear();
+  // one push, so the gl thread never draws half of it.
+  pushCommand(std::move(command));
+  return added;
 }
 
 void ObjectManager::draw() {
-  std::vector<std::shared_ptr<ObjectBase>> to_delete;
+  glApplyCommands();
+  gl::GeometryCache::getInstance().glCollect();
+
+  // cull, batch instances and queue the rest; no gl calls yet.
+  render_queue.clear();
+  latched.clear();
+  uint64_t drawn = 0, culled = 0;
+  core::Profiler& profiler = core::Profiler::getInstance();
+  for (auto& entry : objects) {
+    ObjectBase& object = *entry.object;
+    if (object.is_visible == false) continue;
+
+    if (object.getObjectLayer() != ObjectLayer::GL) {  // imgui only
+      if (object.latency.glLatch()) latched.push_back(&object);
+      profiler.beginObject(&object, entry.name, false);
+      object.draw();
+      profiler.endObject();
+      drawn++;
+      continue;
+    }
+
+    auto& gl_object = static_cast<GLObject&>(object);
+    gl_object.glUpdateTransform();
+    if (gl_object.glIsCulled()) {
+      culled++;
+      continue;
+    }
+
+    drawn++;
+    // hidden / culled objects keep their changes pending, still aging.
+    if (object.latency.glLatch()) latched.push_back(&object);
+    if (glAddInstance(gl_object, entry.name)) continue;  // once per group
+    render_queue.push_back(
+        {gl_object.glSortKey(), &gl_object, nullptr, &entry.name});
+  }
+  glQueueInstances();
 
-  std::lock_guard<std::mutex> lock(mtx_object);
-  to_delete.swap(objects_to_delete);
+  // submit by state, stable so equal keys keep their order between frames.
+  std::stable_sort(
+      render_queue.begin(), render_queue.end(),
+      [](const QueuedDraw& a, const QueuedDraw& b) { return a.key < b.key; });
+  for (const QueuedDraw& queued : render_queue) glDraw(queued);
 
-  for (auto&& object : to_delete) {
-    if (object->getObjectLayer() != ObjectLayer::GL) continue;
-    static_cast<GLObject*>(object.get())->glFree();
+  core::Stats::getInstance().setObjectCounts(drawn, culled);
+}
+
+void ObjectManager::glPresented(std::chrono::steady_clock::time_point present) {
+  // deletes apply at the next draw(), every latched object is still alive.
+  for (ObjectBase* object : latched) object->latency.glPresented(present);
+  latched.clear();
+}
+
+bool ObjectManager::glAddInstance(GLObject& object,
+                                  const std::string& name) {
+  GLObject::Instance instance;
+  if (object.glInstance(instance) == false) return false;
+
+  gl::InstanceAttributes attributes;
+  if (toInstanceAttributes(instance.transform, instance.color, attributes) ==
+      false)
+    return false;
+
+  const InstanceKey key(instance.geometry, instance.state,
+                        typeid(object).hash_code());
+  InstanceGroup& group = instance_groups[key];
+  if (group.instances.empty()) {
+    group.first = &object;
+    group.name = &name;
   }
+  group.instances.push_back(attributes);
+  return true;
+}
 
-  for (const auto& [_, object] : objects) object->draw();
+void ObjectManager::glQueueInstances() {
+  for (auto iter = instance_groups.begin(); iter != instance_groups.end();) {
+    InstanceGroup& group = iter->second;
+    if (group.instances.empty()) {  // none drawn this frame
+      if (group.buffer) group.buffer->free();
+      iter = instance_groups.erase(iter);
+      continue;
+    }
+
+    render_queue.push_back(
+        {group.first->glSortKey(), group.first, &group, group.name});
+    ++iter;
+  }
 }
 
-void ObjectManager::forEachObject(
-    const std::function<void(const std::string&, ObjectBase&)>& fn) {
-  std::lock_guard<std::mutex> lock(mtx_object);
-  for (auto& [name, obj] : objects) fn(name, *obj);
+void ObjectManager::glDraw(const QueuedDraw& queued) {
+  core::Profiler& profiler = core::Profiler::getInstance();
+  if (profiler.enabled()) {
+    // one entry per group, named after its first object
+    const size_t count = queued.group ? queued.group->instances.size() : 1;
+    profiler.beginObject(
+        queued.object,
+        count > 1 ? *queued.name + " (x" + std::to_string(count) + ")"
+                  : *queued.name,
+        true);
+  }
+
+  if (queued.group)
+    glDrawInstances(*queued.group);
+  else
+    queued.object->draw();
+  profiler.endObject();
+}
+
+void ObjectManager::glDrawInstances(InstanceGroup& group) {
+  const size_t count = group.instances.size();
+  if (count == 1)
+    group.first->draw();
+  else {
+    if (group.buffer == nullptr)
+      group.buffer.reset(
+          new gl::StreamBuffer(getConfig().upload_policy, GL_STREAM_DRAW));
+    group.buffer->upload(group.instances.data(),
+                         sizeof(gl::InstanceAttributes) * count);
+    group.first->glDrawInstances(*group.buffer, count);
+  }
+
+  group.instances.clear();
+}
+
+void ObjectManager::glApplyCommands() {
+  Command command;
+  while (commands.pop(command)) glApply(command);
 }
 
-std::string ObjectManager::generateName(ObjectBase* obj) {
-  std::string base_name = obj->getType();
+void ObjectManager::glApply(Command& command) {
+  auto gl_free = [](const std::shared_ptr<ObjectBase>& object) {
+    if (object->getObjectLayer() != ObjectLayer::GL) return;
+    static_cast<GLObject*>(object.get())->glFree();
+  };
+
+  switch (command.type) {
+    case Command::Type::ADD:
+      if (command.entry.object->getObjectLayer() == ObjectLayer::GL) {
+        auto gl_object = static_cast<GLObject*>(command.entry.object.get());
+        if (shader) gl_object->setShader(shader);
+        gl_object->setView(view);
+      }
+      objects.insert(command.handle, std::move(command.entry));
+      break;
+    case Command::Type::DELETE: {
+      Entry* entry = objects.find(command.handle);
+      if (entry == nullptr) break;
+      gl_free(entry->object);
+      objects.erase(command.handle);
+      break;
+    }
+    case Command::Type::CLEAR:
+      for (auto& entry : objects) gl_free(entry.object);
+      objects.clear();
+      break;
+    case Command::Type::UPDATE:
+      if (command.update) command.update();
+      break;
+    case Command::Type::TRANSFORM:
+      if (command.entry.object->getObjectLayer() == ObjectLayer::GL)
+        static_cast<GLObject*>(command.entry.object.get())
+            ->setTransform(command.transform);
+      break;
+    case Command::Type::BATCH:
+      for (auto& sub : command.batch) glApply(sub);
+      break;
+  }
+}
 
-  if (objects.find(base_name) == objects.end()) return base_name;
+void ObjectManager::forEachObject(size_t first,
+                                  size_t last,
+                                  const ObjectVisitor& fn) {
+  last = std::min(last, objects.size());
+  for (size_t i = first; i < last; i++) {
+    Entry& entry = objects.at(i);
+    fn(objects.handleAt(i), entry.name, *entry.object);
+  }
+}
 
-  int i = 2;
-  while (objects.find(base_name + std::to_string(i)) != objects.end()) i++;
+ObjectBase* ObjectManager::findObject(ObjectHandle handle, std::string* name) {
+  Entry* entry = objects.find(handle);
+  if (entry == nullptr) return nullptr;
 
-  return base_name + std::to_string(i);
+  if (name) *name = entry->name;
+  return entry->object.get();
 }
 
 }  // namespace object
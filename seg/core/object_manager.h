@@ -1,52 +1,157 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <tuple>
+#include <unordered_map>
 #include <vector>
 
+#include <Eigen/Dense>
+
+#include "seg/batch.h"
+#include "seg/gl/stream_buffer.h"
+#include "seg/gl/vertex_layout.h"  // gl::InstanceAttributes
+#include "seg/internal/mpsc_queue.h"
+#include "seg/internal/slot_map.h"
+#include "seg/types.h"  // seg::ObjectHandle
+
 namespace seg {
 namespace gl {
 class Shader;
+struct View;
 };
 namespace object {
 class ObjectBase;
+class GLObject;
 
+/**
+ * Objects by generational handle, in a dense slot map; names are an
+ * optional side index.
+ * API calls (add / delete / get) run on any thread and never wait on
+ * rendering: they update an api side table and queue the change. The gl
+ * thread replays queued changes at the start of draw() onto its own copy,
+ * which it draws from without locks.
+ * Objects of one type drawing the same shared geometry with the same state
+ * (see GLObject::glInstance) are drawn in one instanced draw per frame.
+ * Each frame is culled and queued first, then drawn sorted by state.
+ */
 class ObjectManager {
  public:
+  using ObjectVisitor = std::function<void(ObjectHandle handle,
+                                           const std::string& name,
+                                           ObjectBase& object)>;
+
   ~ObjectManager();
 
+  // gl thread side =================================================
   void setShader(gl::Shader* shader);
+  void setView(const gl::View* view);
+
+  // applies queued changes, then draws.
+  void draw();
+  // the frame of the last draw() is on screen, for DataLatency.
+  void glPresented(std::chrono::steady_clock::time_point present);
+
+  // objects as of the last draw(), in draw order.
+  size_t objectCount() const { return objects.size(); }
+  void forEachObject(size_t first, size_t last, const ObjectVisitor& fn);
+  void forEachObject(const ObjectVisitor& fn) {
+    forEachObject(0, objectCount(), fn);
+  }
+  ObjectBase* findObject(ObjectHandle handle, std::string* name = nullptr);
 
-  std::string addObject(ObjectBase* obj);
-  std::string addObject(const std::shared_ptr<ObjectBase>& obj);
-  void addObject(const std::string& name, ObjectBase* obj);
-  void addObject(const std::string& name,
-                 const std::shared_ptr<ObjectBase>& obj);
+  // api side, any thread =============================================
+  /**
+   * @param name - empty: unnamed, displayed as "<type> #<slot>".
+   *        otherwise unique, else the add fails.
+   * @return handle, invalid if the add failed.
+   */
+  ObjectHandle addObject(const std::shared_ptr<ObjectBase>& obj,
+                         const std::string& name = "");
+  std::weak_ptr<ObjectBase> getObject(ObjectHandle handle);
   std::weak_ptr<ObjectBase> getObject(const std::string& name);
 
+  bool deleteObject(ObjectHandle handle);
   bool deleteObject(const std::string& name);
   void clearObjects();
 
-  void draw();
-
-  void forEachObject(
-      const std::function<void(const std::string&, ObjectBase&)>& fn);
+  /**
+   * @brief Applies every change of batch in one frame, under one lock.
+   * @return handles of the staged adds in order, invalid where one failed.
+   */
+  std::vector<ObjectHandle> commit(Batch&& batch);
 
  private:
-  std::string insertObject(const std::shared_ptr<ObjectBase>& obj,
-                           const std::string& name = "");
-  std::string generateName(ObjectBase* object);
+  struct Entry {
+    std::shared_ptr<ObjectBase> object;
+    std::string name;
+  };
 
-  gl::Shader* shader = nullptr;
-  std::mutex mtx_object;
-  bool shut_down = false;
-  std::map<std::string, std::shared_ptr<ObjectBase>> objects;
+  struct Command {
+    enum class Type { ADD, DELETE, CLEAR, UPDATE, TRANSFORM, BATCH };
+
+    Type type = Type::ADD;
+    ObjectHandle handle;
+    Entry entry;                   // ADD, TRANSFORM
+    std::function<void()> update;  // UPDATE
+    Eigen::Matrix4f transform;     // TRANSFORM
+    std::vector<Command> batch;    // BATCH, applied in one go
+  };
+
+  // fill command instead of pushing it, callers hold api_mtx.
+  ObjectHandle addObjectLocked(const std::shared_ptr<ObjectBase>& obj,
+                               const std::string& name,
+                               Command& command);
+  bool deleteObjectLocked(ObjectHandle handle, Command& command);
+  void pushCommand(Command&& command);
+  void glApplyCommands();
+  void glApply(Command& command);
+
+  // draws sharing geometry, type and state.
+  struct InstanceGroup {
+    GLObject* first = nullptr;
+    const std::string* name = nullptr;  // of first
+    std::vector<gl::InstanceAttributes> instances;  // this frame
+    std::unique_ptr<gl::StreamBuffer> buffer;
+  };
+  using InstanceKey = std::tuple<const void*, uint64_t, size_t>;
 
-  std::vector<std::shared_ptr<ObjectBase>>
-      objects_to_delete;  // To Delete in gl thread;
+  // false if the object has to draw on its own.
+  bool glAddInstance(GLObject& object, const std::string& name);
+  // queues the groups of this frame, drops the others.
+  void glQueueInstances();
+  void glDrawInstances(InstanceGroup& group);
+
+  // a draw of this frame, submitted in key order. (see GLObject::glSortKey)
+  struct QueuedDraw {
+    uint64_t key;
+    GLObject* object;
+    InstanceGroup* group;  // nullptr - object on its own
+    const std::string* name;
+  };
+  // profiled draw of queued
+  void glDraw(const QueuedDraw& queued);
+
+  // api side, guarded by api_mtx. the gl thread never locks it.
+  std::mutex api_mtx;
+  SlotMap<Entry> api_objects;
+  std::unordered_map<std::string, ObjectHandle> names;  // named objects
+  std::atomic<bool> shut_down{false};
+  MpscQueue<Command> commands;
+
+  // gl thread side
+  gl::Shader* shader = nullptr;
+  const gl::View* view = nullptr;
+  SlotMap<Entry> objects;  // replica of api_objects
+  std::map<InstanceKey, InstanceGroup> instance_groups;
+  std::vector<QueuedDraw> render_queue;
+  std::vector<ObjectBase*> latched;  // took changed data this frame
 
 };  // class ObjectManager
 }  // namespace object
@@ -0,0 +1,208 @@
+#include "seg/core/profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "seg/core/config.h"
+
+static std::once_flag instance_flag;
+static std::unique_ptr<seg::core::Profiler> profiler;
+
+namespace seg {
+namespace core {
+const char* Profiler::phaseName(Phase phase) {
+  switch (phase) {
+    case PHASE_UI:
+      return "UI";
+    case PHASE_WAIT:
+      return "Wait";
+    case PHASE_SCENE:
+      return "Scene";
+    case PHASE_OBJECTS:
+      return "Objects";
+    case PHASE_IMGUI:
+      return "ImGui";
+    case PHASE_SWAP:
+      return "Swap";
+    default:
+      return "";
+  }
+}
+
+Profiler& Profiler::getInstance() {
+  std::call_once(instance_flag, [] { profiler.reset(new Profiler()); });
+
+  return *(profiler.get());
+}
+
+void Profiler::beginFrame() {
+  recording = getConfig().show_profiler;
+  if (recording == false) return;
+
+  frame_count++;
+  frame_start = Clock::now();
+  phase = PHASE_COUNT;
+  phase_ms.fill(0.0);
+  frame_objects.clear();
+
+  collectQueries();
+  // still pending after QUERY_FRAMES frames, those results are dropped.
+  query_slots[frame_count % QUERY_FRAMES].used = 0;
+}
+
+void Profiler::beginPhase(Phase _phase) {
+  if (recording == false) return;
+
+  const Clock::time_point now = Clock::now();
+  endPhase(now);
+  phase = _phase;
+  phase_start = now;
+}
+
+void Profiler::endPhase(Clock::time_point now) {
+  if (phase == PHASE_COUNT) return;
+  phase_ms[phase] += toMs(now - phase_start);
+  phase = PHASE_COUNT;
+}
+
+void Profiler::endFrame() {
+  if (recording == false) return;
+
+  const Clock::time_point now = Clock::now();
+  endPhase(now);
+  const double frame_ms = toMs(now - frame_start);
+  last_phase_ms = phase_ms;
+  frame_times[frame_count % GRAPH_FRAMES] = static_cast<float>(frame_ms);
+
+  // the first frame recorded also sets up imgui windows, not a hitch.
+  if (frame_ms > getConfig().frame_budget_ms && frame_count > 1) {
+    Hitch hitch;
+    hitch.frame = frame_count;
+    hitch.frame_ms = frame_ms;
+    hitch.phase_ms = phase_ms;
+
+    const size_t count = std::min(HITCH_OBJECTS, frame_objects.size());
+    std::partial_sort(
+        frame_objects.begin(), frame_objects.begin() + count,
+        frame_objects.end(),
+        [](const auto& a, const auto& b) { return a.second > b.second; });
+    for (size_t i = 0; i < count; i++) {
+      const ObjectStats& stats = *frame_objects[i].first;
+      hitch.slowest.push_back({stats.name, frame_objects[i].second,
+                               stats.gpu_ms});
+    }
+
+    hitch_list.push_back(std::move(hitch));
+    if (hitch_list.size() > HITCH_HISTORY) hitch_list.pop_front();
+  }
+  frame_objects.clear();
+
+  if (frame_count % PRUNE_FRAMES == 0) {
+    for (auto iter = object_stats.begin(); iter != object_stats.end();) {
+      if (iter->second.last_frame + PRUNE_FRAMES < frame_count)
+        iter = object_stats.erase(iter);
+      else
+        ++iter;
+    }
+  }
+}
+
+void Profiler::beginObject(const void* object,
+                           const std::string& name,
+                           bool gpu) {
+  if (recording == false) return;
+
+  timed = &object_stats[object];
+  if (timed->name != name) timed->name = name;
+  object_query = gpu;
+  if (gpu) {
+    QuerySlot& slot = query_slots[frame_count % QUERY_FRAMES];
+    if (slot.used == slot.queries.size()) {
+      GLuint query = 0;
+      glGenQueries(1, &query);
+      slot.queries.push_back(query);
+      slot.objects.push_back(nullptr);
+    }
+    slot.objects[slot.used] = object;
+    glBeginQuery(GL_TIME_ELAPSED, slot.queries[slot.used]);
+  }
+  object_start = Clock::now();
+}
+
+void Profiler::endObject() {
+  if (recording == false || timed == nullptr) return;
+
+  if (object_query) {
+    glEndQuery(GL_TIME_ELAPSED);
+    query_slots[frame_count % QUERY_FRAMES].used++;
+  }
+  const double ms = toMs(Clock::now() - object_start);
+
+  if (timed->last_frame == 0)
+    timed->cpu_ms = ms;
+  else
+    timed->cpu_ms += SMOOTHING * (ms - timed->cpu_ms);
+  timed->last_frame = frame_count;
+  frame_objects.emplace_back(timed, ms);
+  timed = nullptr;
+}
+
+void Profiler::collectQueries() {
+  for (QuerySlot& slot : query_slots) {
+    if (slot.used == 0) continue;
+
+    // queries finish in submission order, the last one done means all are.
+    GLint available = GL_FALSE;
+    glGetQueryObjectiv(slot.queries[slot.used - 1], GL_QUERY_RESULT_AVAILABLE,
+                       &available);
+    if (available == GL_FALSE) continue;
+
+    for (size_t i = 0; i < slot.used; i++) {
+      GLuint64 elapsed = 0;
+      glGetQueryObjectui64v(slot.queries[i], GL_QUERY_RESULT, &elapsed);
+      auto iter = object_stats.find(slot.objects[i]);
+      if (iter == object_stats.end()) continue;  // pruned since
+
+      ObjectStats& stats = iter->second;
+      const double ms = static_cast<double>(elapsed) / 1e6;
+      if (stats.gpu_ms < 0.0)
+        stats.gpu_ms = ms;
+      else
+        stats.gpu_ms += SMOOTHING * (ms - stats.gpu_ms);
+    }
+    slot.used = 0;
+  }
+}
+
+std::vector<Profiler::ObjectTime> Profiler::slowestObjects(
+    size_t count) const {
+  std::vector<ObjectTime> times;
+  times.reserve(object_stats.size());
+  for (const auto& [object, stats] : object_stats) {
+    // hidden or culled lately
+    if (stats.last_frame + QUERY_FRAMES < frame_count) continue;
+    times.push_back({stats.name, stats.cpu_ms, stats.gpu_ms});
+  }
+
+  count = std::min(count, times.size());
+  std::partial_sort(times.begin(), times.begin() + count, times.end(),
+                    [](const ObjectTime& a, const ObjectTime& b) {
+                      return a.cpu_ms + std::max(a.gpu_ms, 0.0) >
+                             b.cpu_ms + std::max(b.gpu_ms, 0.0);
+                    });
+  times.resize(count);
+  return times;
+}
+
+double Profiler::toMs(Clock::duration duration) {
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+}  // namespace core
+}  // namespace seg
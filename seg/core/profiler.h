@@ -0,0 +1,133 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <GL/glew.h>
+
+namespace seg {
+namespace core {
+/**
+ * Frame profiler of the SEG thread, recording while Config::show_profiler.
+ * CPU time of the App::draw phases and of each object draw; GPU time of
+ * each GL object from GL_TIME_ELAPSED queries, kept in a ring of frames and
+ * read once available, so reading never waits on the gpu. A frame over
+ * Config::frame_budget_ms is kept as a hitch, with its breakdown.
+ * gl thread only.
+ */
+class Profiler {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  enum Phase {
+    PHASE_UI,       // events, imgui frame, Controller::drawUI()
+    PHASE_WAIT,     // low latency pacing
+    PHASE_SCENE,    // Scene::draw(), grid and axis
+    PHASE_OBJECTS,  // ObjectManager::draw()
+    PHASE_IMGUI,    // imgui draw data
+    PHASE_SWAP,     // swap, gpu sync
+    PHASE_COUNT,
+  };
+  static const char* phaseName(Phase phase);
+
+  // an object, or an instance group drawn as one
+  struct ObjectTime {
+    std::string name;
+    double cpu_ms = 0.0;
+    double gpu_ms = -1.0;  // -1: not measured (imgui objects)
+  };
+
+  // gpu_ms of a hitch is the moving average, its own frame isn't read yet.
+  struct Hitch {
+    uint64_t frame = 0;
+    double frame_ms = 0.0;
+    std::array<double, PHASE_COUNT> phase_ms{};
+    std::vector<ObjectTime> slowest;  // of that frame, by cpu time
+  };
+
+  static Profiler& getInstance();
+
+  bool enabled() const { return recording; }
+
+  void beginFrame();
+  // ends the phase running, if any
+  void beginPhase(Phase phase);
+  void endFrame();
+
+  /**
+   * @brief Times the draw of object until endObject(). Not nested.
+   * @param gpu - with a GL_TIME_ELAPSED query as well, GL objects only.
+   */
+  void beginObject(const void* object, const std::string& name, bool gpu);
+  void endObject();
+
+  // moving averages, slowest first by cpu + gpu time
+  std::vector<ObjectTime> slowestObjects(size_t count) const;
+
+  // ms, oldest first from frameTimeOffset(), as ImGui::PlotLines takes it
+  static constexpr int GRAPH_FRAMES = 240;
+  const float* frameTimes() const { return frame_times.data(); }
+  int frameTimeOffset() const {
+    return static_cast<int>((frame_count + 1) % GRAPH_FRAMES);
+  }
+  const std::array<double, PHASE_COUNT>& lastPhases() const {
+    return last_phase_ms;
+  }
+  const std::deque<Hitch>& hitches() const { return hitch_list; }
+  void clearHitches() { hitch_list.clear(); }
+
+ private:
+  Profiler() {}
+
+  static constexpr int QUERY_FRAMES = 4;  // frames a query has to finish
+  static constexpr size_t HITCH_HISTORY = 16;
+  static constexpr size_t HITCH_OBJECTS = 8;
+  static constexpr uint64_t PRUNE_FRAMES = 120;  // unseen objects are dropped
+  static constexpr double SMOOTHING = 0.1;
+
+  struct ObjectStats {
+    std::string name;
+    double cpu_ms = 0.0;
+    double gpu_ms = -1.0;
+    uint64_t last_frame = 0;
+  };
+
+  // queries of one frame, reused QUERY_FRAMES later
+  struct QuerySlot {
+    std::vector<GLuint> queries;
+    std::vector<const void*> objects;  // of queries[i]
+    size_t used = 0;
+  };
+
+  void collectQueries();
+  void endPhase(Clock::time_point now);
+  static double toMs(Clock::duration duration);
+
+  bool recording = false;
+  uint64_t frame_count = 0;
+  Clock::time_point frame_start;
+
+  int phase = PHASE_COUNT;  // running, PHASE_COUNT - none
+  Clock::time_point phase_start;
+  std::array<double, PHASE_COUNT> phase_ms{};
+  std::array<double, PHASE_COUNT> last_phase_ms{};
+
+  ObjectStats* timed = nullptr;  // between beginObject / endObject
+  Clock::time_point object_start;
+  bool object_query = false;
+  std::vector<std::pair<const ObjectStats*, double>> frame_objects;  // ms
+
+  std::unordered_map<const void*, ObjectStats> object_stats;
+  std::array<QuerySlot, QUERY_FRAMES> query_slots;
+  std::array<float, GRAPH_FRAMES> frame_times{};
+  std::deque<Hitch> hitch_list;
+
+};  // class Profiler
+}  // namespace core
+}  // namespace seg
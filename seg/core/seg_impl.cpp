@@ -2,10 +2,13 @@
 #include <memory>
 #include <mutex>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 #include "seg/core/app.h"
 #include "seg/core/config.h"
 #include "seg/core/object_manager.h"
+#include "seg/core/stats.h"
 #include "seg/gl/scene.h"
 #include "seg/object/gl/basic_renderers.h"
 #include "seg/object/primitives.h"
@@ -45,6 +48,14 @@ void createInstances() {
 void setOptions(Options options) {
   SET_LOG_LEVEL(static_cast<int>(options.verbosity));
   getConfig().theme = options.theme;
+  getConfig().upload_policy = options.upload_policy;
+  getConfig().render_mode = options.render_mode;
+  getConfig().frame_pacing = options.frame_pacing;
+  getConfig().frame_cap = options.frame_cap;
+  getConfig().gpu_sync = options.gpu_sync;
+  getConfig().frame_budget_ms = options.frame_budget_ms;
+  getConfig().use_shader_cache = options.use_shader_cache;
+  getConfig().shader_cache_dir = options.shader_cache_dir;
 }
 
 void initializeApp(const std::string& window_name,
@@ -85,33 +96,59 @@ void run() {
   app->appMain();
 }
 
-void addObject(const std::string& name,
-               const std::shared_ptr<object::ObjectBase>& object) {
+ObjectHandle addObject(const std::string& name,
+                       const std::shared_ptr<object::ObjectBase>& object) {
   ensureInitialized();
 
-  object_manager->addObject(name, object);
+  return object_manager->addObject(object, name);
 }
 
-void addObject(const std::string& name, object::ObjectBase* object) {
-  addObject(name, std::shared_ptr<object::ObjectBase>(object));
+ObjectHandle addObject(const std::string& name, object::ObjectBase* object) {
+  return addObject(name, std::shared_ptr<object::ObjectBase>(object));
 }
 
-std::string addObject(const std::shared_ptr<object::ObjectBase>& object) {
+ObjectHandle addObject(const std::shared_ptr<object::ObjectBase>& object) {
   ensureInitialized();
 
   return object_manager->addObject(object);
 }
 
-std::string addObject(object::ObjectBase* object) {
+ObjectHandle addObject(object::ObjectBase* object) {
   return addObject(std::shared_ptr<object::ObjectBase>(object));
 }
 
+bool deleteObject(ObjectHandle handle) {
+  ensureInitialized();
+
+  return object_manager->deleteObject(handle);
+}
+
 bool deleteObject(const std::string& name) {
   ensureInitialized();
 
   return object_manager->deleteObject(name);
 }
 
+std::vector<ObjectHandle> commit(Batch&& batch) {
+  ensureInitialized();
+
+  return object_manager->commit(std::move(batch));
+}
+
+FrameStats getFrameStats() {
+  ensureInitialized();
+
+  return core::Stats::getInstance().snapshot();
+}
+
+DataLatencyStats getDataLatency(ObjectHandle handle) {
+  ensureInitialized();
+
+  auto object = object_manager->getObject(handle).lock();
+  if (object == nullptr) return DataLatencyStats();
+  return object->getDataLatency();
+}
+
 void shutdown() {
   ensureInitialized();
 
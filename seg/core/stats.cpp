@@ -0,0 +1,116 @@
+#include "seg/core/stats.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "seg/core/data_latency.h"
+
+static std::once_flag instance_flag;
+static std::unique_ptr<seg::core::Stats> stats;
+
+namespace seg {
+namespace core {
+Stats& Stats::getInstance() {
+  std::call_once(instance_flag, [] { stats.reset(new Stats()); });
+
+  return *(stats.get());
+}
+
+void Stats::onFrameSwapped(double latency) {
+  const auto now = std::chrono::steady_clock::now();
+
+  std::lock_guard<std::mutex> lock(mtx);
+  latencies[frame_count % FRAME_HISTORY] = latency * 1e3;
+  if (frame_count != 0) {
+    const double elapsed_ms =
+        std::chrono::duration<double, std::milli>(now - last_swap).count();
+    frame_times[frame_count % FRAME_HISTORY] = elapsed_ms;
+  } else
+    first_frame_ms =
+        std::chrono::duration<double, std::milli>(now - start).count();
+  last_swap = now;
+  frame_count++;
+}
+
+void Stats::addUpload(uint64_t bytes, double seconds) {
+  upload_bytes.fetch_add(bytes);
+  upload_nanoseconds.fetch_add(static_cast<uint64_t>(seconds * 1e9));
+}
+
+void Stats::addDataLatency(float to_upload_ms, float to_present_ms) {
+  std::lock_guard<std::mutex> lock(latency_mtx);
+  to_upload[latency_count % LATENCY_HISTORY] = to_upload_ms;
+  to_present[latency_count % LATENCY_HISTORY] = to_present_ms;
+  latency_count++;
+}
+
+FrameStats Stats::snapshot() {
+  FrameStats out;
+
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    out.frame_count = frame_count;
+    out.first_frame_ms = first_frame_ms;
+
+    // first frame has no interval
+    const int samples = static_cast<int>(
+        std::min<uint64_t>(frame_count > 0 ? frame_count - 1 : 0,
+                           FRAME_HISTORY));
+    if (samples > 0) {
+      out.frame_time_ms = frame_times[(frame_count - 1) % FRAME_HISTORY];
+
+      double sum = 0.0, sq_sum = 0.0;
+      for (int i = 0; i < samples; i++) {
+        const double t = frame_times[(frame_count - 1 - i) % FRAME_HISTORY];
+        sum += t;
+        sq_sum += t * t;
+      }
+      out.frame_time_mean_ms = sum / samples;
+      out.frame_time_stddev_ms = std::sqrt(std::max(
+          0.0, sq_sum / samples - out.frame_time_mean_ms *
+                                      out.frame_time_mean_ms));
+    }
+
+    const int latency_samples =
+        static_cast<int>(std::min<uint64_t>(frame_count, FRAME_HISTORY));
+    if (latency_samples > 0) {
+      out.latency_ms = latencies[(frame_count - 1) % FRAME_HISTORY];
+
+      double sum = 0.0;
+      for (int i = 0; i < latency_samples; i++) sum += latencies[i];
+      out.latency_mean_ms = sum / latency_samples;
+    }
+  }
+
+  {
+    std::vector<float> upload, present;
+    {
+      std::lock_guard<std::mutex> lock(latency_mtx);
+      out.data_latency.count = latency_count;
+      const size_t samples =
+          std::min<uint64_t>(latency_count, LATENCY_HISTORY);
+      upload.assign(to_upload.begin(), to_upload.begin() + samples);
+      present.assign(to_present.begin(), to_present.begin() + samples);
+    }
+    out.data_latency.to_upload = percentiles(upload);
+    out.data_latency.to_present = percentiles(present);
+  }
+
+  out.upload_bytes = upload_bytes.load();
+  out.upload_time_ms = upload_nanoseconds.load() * 1e-6;
+  out.upload_stalls = upload_stalls.load();
+  out.objects_drawn = objects_drawn.load();
+  out.objects_culled = objects_culled.load();
+  out.draw_calls = draw_calls.load();
+  out.state_changes = state_changes.load();
+  out.programs_cached = programs_cached.load();
+  out.programs_compiled = programs_compiled.load();
+  return out;
+}
+
+}  // namespace core
+}  // namespace seg
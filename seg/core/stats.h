@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+#include "seg/stats.h"
+
+namespace seg {
+namespace core {
+/**
+ * Collects FrameStats on the SEG thread, hands out snapshots to any thread.
+ */
+class Stats {
+ public:
+  static Stats& getInstance();
+
+  void markStart() { start = std::chrono::steady_clock::now(); }
+  // latency - object data latch to present, seconds
+  void onFrameSwapped(double latency = 0.0);
+  void addUpload(uint64_t bytes, double seconds);
+  void addUploadStall() { upload_stalls.fetch_add(1); }
+  // one change on screen, see DataLatency
+  void addDataLatency(float to_upload_ms, float to_present_ms);
+  void setObjectCounts(uint64_t drawn, uint64_t culled) {
+    objects_drawn.store(drawn);
+    objects_culled.store(culled);
+  }
+  void setRenderCounts(uint64_t _draw_calls, uint64_t _state_changes) {
+    draw_calls.store(_draw_calls);
+    state_changes.store(_state_changes);
+  }
+  void setProgramCounts(uint64_t cached, uint64_t compiled) {
+    programs_cached.store(cached);
+    programs_compiled.store(compiled);
+  }
+
+  FrameStats snapshot();
+
+ private:
+  Stats() {};
+
+  static const int FRAME_HISTORY = 240;
+  static const int LATENCY_HISTORY = 1024;
+
+  std::mutex mtx;
+  uint64_t frame_count = 0;
+  std::array<double, FRAME_HISTORY> frame_times{};
+  std::array<double, FRAME_HISTORY> latencies{};
+  std::chrono::steady_clock::time_point last_swap;
+  std::chrono::steady_clock::time_point start;
+  double first_frame_ms = 0.0;
+
+  std::mutex latency_mtx;
+  uint64_t latency_count = 0;
+  std::array<float, LATENCY_HISTORY> to_upload{};
+  std::array<float, LATENCY_HISTORY> to_present{};
+
+  std::atomic<uint64_t> upload_bytes{0};
+  std::atomic<uint64_t> upload_nanoseconds{0};
+  std::atomic<uint64_t> upload_stalls{0};
+  std::atomic<uint64_t> objects_drawn{0};
+  std::atomic<uint64_t> objects_culled{0};
+  std::atomic<uint64_t> draw_calls{0};
+  std::atomic<uint64_t> state_changes{0};
+  std::atomic<uint64_t> programs_cached{0};
+  std::atomic<uint64_t> programs_compiled{0};
+
+};  // class Stats
+}  // namespace core
+}  // namespace seg
@@ -52,6 +52,7 @@ class Camera {
   const Eigen::Matrix4f& getProjectionMatrix() const {
     return projection_matrix;
   }
+  const Eigen::Vector2i& getWindowSize() const { return window_size; }
 
  private:
   void updateViewMatrix();
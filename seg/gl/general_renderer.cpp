@@ -1,181 +1,742 @@
 #include "seg/gl/general_renderer.h"
 
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <mutex>
 #include <stdexcept>
+#include <unordered_map>
 
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 
-#include "seg/gl/shader.h"
+#include "seg/core/config.h"
+#include "seg/core/data_latency.h"
+#include "seg/core/frame_request.h"
+#include "seg/gl/instance_buffer.h"
+#include "seg/gl/render_state.h"
 #include "seg/internal/logger.h"
 
 namespace seg {
 namespace gl {
-GeneralRenderer::~GeneralRenderer() { glFree(); }
+namespace {
+UploadPolicy selectPolicy(GeneralRenderer::BufferType type) {
+  // static buffers are written once, streaming machinery only costs memory.
+  if (type == GeneralRenderer::BufferType::STATIC)
+    return UploadPolicy::REALLOCATE;
+  return getConfig().upload_policy;
+}
 
-void GeneralRenderer::draw(Shader* shader) {
-  if (updated.load() == true) {
-    glMalloc();
-    updated.store(false);
+// quantization grid. int16 over a 64 m cell keeps ~1 mm resolution.
+constexpr float CHUNK_SIZE = 64.0f;
+
+/**
+ * Buckets vertices into CHUNK_SIZE cells; fills chunks with each cell's
+ * contiguous range and bounding box, and the chunk index of every vertex.
+ */
+template <typename P>
+void binChunks(const AttributeView& vertices,
+               std::vector<GeneralRenderer::Chunk>& chunks,
+               std::vector<uint32_t>& vertex_chunk) {
+  std::unordered_map<uint64_t, uint32_t> cell_chunk;
+  std::vector<Eigen::AlignedBox3f> boxes;
+  std::vector<size_t> counts;
+
+  vertex_chunk.resize(vertices.count);
+  for (size_t i = 0; i < vertices.count; i++) {
+    const Eigen::Vector3f vertex = readVector3<P>(vertices, i);
+    const Eigen::Vector3i cell =
+        (vertex / CHUNK_SIZE).array().floor().template cast<int>();
+    const uint64_t key = (uint64_t(cell.x()) & 0x1fffff) |
+                         ((uint64_t(cell.y()) & 0x1fffff) << 21) |
+                         ((uint64_t(cell.z()) & 0x1fffff) << 42);
+
+    auto it = cell_chunk.emplace(key, uint32_t(boxes.size())).first;
+    if (it->second == boxes.size()) {
+      boxes.emplace_back();
+      counts.push_back(0);
+    }
+    boxes[it->second].extend(vertex);
+    counts[it->second]++;
+    vertex_chunk[i] = it->second;
   }
 
-  glBindVertexArray(vao);
+  chunks.resize(boxes.size());
+  size_t first = 0;
+  for (size_t c = 0; c < chunks.size(); c++) {
+    chunks[c].first = first;
+    chunks[c].count = counts[c];
+    chunks[c].origin = boxes[c].center();
+    chunks[c].scale = (boxes[c].sizes() * 0.5f).cwiseMax(1e-6f);
+    first += counts[c];
+  }
+}
 
-  const GLuint vertex_id = shader->getAttribId("vertex_pos_model");
-  glEnableVertexAttribArray(vertex_id);
-  glBindBuffer(GL_ARRAY_BUFFER, vbo);
-  glVertexAttribPointer(vertex_id, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+/**
+ * Converts and packs views into out, one pass over the caller's memory.
+ * (quantized layouts read positions once more to bin them into chunks)
+ * Empty colors / scalars are zero filled. box is extended by every vertex.
+ */
+template <typename Layout, typename P, typename C, typename S>
+void packTyped(typename Layout::Vertex* out,
+               const AttributeView& vertices,
+               const AttributeView& colors,
+               const AttributeView& scalars,
+               std::vector<GeneralRenderer::Chunk>& chunks,
+               Eigen::AlignedBox3f& box) {
+  const bool with_color = colors.empty() == false;
+  const bool with_scalar = scalars.empty() == false;
+
+  std::vector<uint32_t> vertex_chunk;
+  std::vector<size_t> fill;
+  if constexpr (Layout::quantized) {
+    binChunks<P>(vertices, chunks, vertex_chunk);
+    fill.assign(chunks.size(), 0);
+  }
+
+  Eigen::Vector3f color = Eigen::Vector3f::Zero();
+  float scalar = 0.0f;
+  for (size_t i = 0; i < vertices.count; i++) {
+    Eigen::Vector3f position = readVector3<P>(vertices, i);
+    box.extend(position);
+    size_t at = i;
+
+    if constexpr (Layout::quantized) {
+      const auto& chunk = chunks[vertex_chunk[i]];
+      at = chunk.first + fill[vertex_chunk[i]]++;
+      position = (position - chunk.origin).cwiseQuotient(chunk.scale);
+    }
+    if constexpr (Layout::has_color) {
+      if (with_color) color = readVector3<C>(colors, i);
+    }
+    if constexpr (Layout::has_scalar) {
+      if (with_scalar) scalar = static_cast<float>(*element<S>(scalars, i));
+    }
 
-  if (cbo != 0) {
-    const GLuint color_id = shader->getAttribId("vertex_color_rgb");
-    glEnableVertexAttribArray(color_id);
-    glBindBuffer(GL_ARRAY_BUFFER, cbo);
-    glVertexAttribPointer(color_id, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+    packVertex<Layout>(out[at], position, &color, &scalar);
   }
+}
+
+template <typename Layout>
+void packViews(typename Layout::Vertex* out,
+               const AttributeView& vertices,
+               const AttributeView& colors,
+               const AttributeView& scalars,
+               std::vector<GeneralRenderer::Chunk>& chunks,
+               Eigen::AlignedBox3f& box) {
+  visitType(vertices, [&](auto p) {
+    visitType(colors, [&](auto c) {
+      visitType(scalars, [&](auto s) {
+        packTyped<Layout, decltype(p), decltype(c), decltype(s)>(
+            out, vertices, colors, scalars, chunks, box);
+      });
+    });
+  });
+}
+
+Eigen::AlignedBox3f boundsOf(const AttributeView& vertices) {
+  Eigen::AlignedBox3f box;
+  visitType(vertices, [&](auto p) {
+    for (size_t i = 0; i < vertices.count; i++)
+      box.extend(readVector3<decltype(p)>(vertices, i));
+  });
+  return box;
+}
+
+// colors / scalars as packTyped() reads them, kept for later updates.
+std::shared_ptr<const std::vector<Eigen::Vector3f>> copyColors(
+    const AttributeView& colors) {
+  auto copy = std::make_shared<std::vector<Eigen::Vector3f>>(colors.count);
+  visitType(colors, [&](auto c) {
+    for (size_t i = 0; i < colors.count; i++)
+      (*copy)[i] = readVector3<decltype(c)>(colors, i);
+  });
+  return copy;
+}
+
+std::shared_ptr<const std::vector<float>> copyScalars(
+    const AttributeView& scalars) {
+  auto copy = std::make_shared<std::vector<float>>(scalars.count);
+  visitType(scalars, [&](auto s) {
+    for (size_t i = 0; i < scalars.count; i++)
+      (*copy)[i] = static_cast<float>(*element<decltype(s)>(scalars, i));
+  });
+  return copy;
+}
+
+template <typename Layout>
+std::unique_ptr<GeneralRenderer> makeRenderer(
+    GeneralRenderer::BufferType buffer_type,
+    GeneralRenderer::RenderTarget render_target) {
+  return std::make_unique<Renderer<Layout>>(buffer_type, render_target);
+}
+}  // namespace
+
+// GeneralRenderer ======================================================
+Eigen::Matrix4f GeneralRenderer::Chunk::dequantize() const {
+  Eigen::Matrix4f matrix = Eigen::Matrix4f::Identity();
+  matrix.diagonal().head<3>() = scale;
+  matrix.block<3, 1>(0, 3) = origin;
+  return matrix;
+}
+
+std::unique_ptr<GeneralRenderer> GeneralRenderer::create(
+    BufferType buffer_type,
+    RenderTarget render_target,
+    bool with_color,
+    bool with_scalar,
+    VertexFormat format) {
+  using namespace layout;
+
+  if (format == VertexFormat::FLOAT) {
+    if (with_color && with_scalar)
+      return makeRenderer<PositionColorScalar>(buffer_type, render_target);
+    if (with_color)
+      return makeRenderer<PositionColor>(buffer_type, render_target);
+    if (with_scalar)
+      return makeRenderer<PositionScalar>(buffer_type, render_target);
+    return makeRenderer<Position>(buffer_type, render_target);
+  }
+
+  if (render_target != RenderTarget::POINT) {
+    LOG_ERROR("GeneralRenderer - Compact vertex format is points only.");
+    throw std::invalid_argument(
+        "Compact vertex format is supported for points only!");
+  }
+
+  const bool scalar8 = (format == VertexFormat::COMPACT8);
+  if (with_color && with_scalar)
+    return scalar8 ? makeRenderer<CompactPositionColorScalar<uint8_t>>(
+                         buffer_type, render_target)
+                   : makeRenderer<CompactPositionColorScalar<Half>>(
+                         buffer_type, render_target);
+  if (with_color)
+    return makeRenderer<CompactPositionColor>(buffer_type, render_target);
+  if (with_scalar)
+    return scalar8 ? makeRenderer<CompactPositionScalar<uint8_t>>(
+                         buffer_type, render_target)
+                   : makeRenderer<CompactPositionScalar<Half>>(
+                         buffer_type, render_target);
+  return makeRenderer<CompactPosition>(buffer_type, render_target);
+}
+
+void GeneralRenderer::updateData(const std::vector<size_t>& indices,
+                                 const std::vector<Eigen::Vector3f>& vertices) {
+  if (indices.size() != vertices.size()) {
+    LOG_ERROR("GeneralRenderer - updateData size mismatch!");
+    throw std::invalid_argument("Indices and vertices differ in size!");
+  }
+  updateDataImpl(indices.data(), 0, vertices.data(), vertices.size());
+}
+
+void GeneralRenderer::setData(std::vector<Eigen::Vector3f>&& vertices,
+                              std::vector<float>&& scalars) {
+  setData(std::move(vertices), std::vector<Eigen::Vector3f>(),
+          std::move(scalars));
+}
+
+void GeneralRenderer::setData(std::vector<Eigen::Vector3f>&& vertices,
+                              std::vector<Triangle>&& indices) {
+  setData(std::move(vertices), std::vector<Eigen::Vector3f>(),
+          std::vector<float>(), std::move(indices));
+}
+
+void GeneralRenderer::setData(std::vector<Eigen::Vector3f>&& vertices,
+                              std::vector<Eigen::Vector3f>&& colors,
+                              std::vector<Triangle>&& indices) {
+  setData(std::move(vertices), std::move(colors), std::vector<float>(),
+          std::move(indices));
+}
+
+void GeneralRenderer::onPublished(const Eigen::AlignedBox3f& box) {
+  box_mailbox.back() = box;
+  box_mailbox.publish();
+  if (latency) latency->stamp();
+  FrameRequest::request();
+}
 
-  if (sbo != 0) {
-    const GLuint intensity_id = shader->getAttribId("vertex_intensity");
-    glEnableVertexAttribArray(intensity_id);
-    glBindBuffer(GL_ARRAY_BUFFER, sbo);
-    glVertexAttribPointer(intensity_id, 1, GL_FLOAT, GL_FALSE, 0, (void*)0);
+const Eigen::AlignedBox3f& GeneralRenderer::glBounds() {
+  const Eigen::AlignedBox3f* fresh = box_mailbox.consume();
+  if (fresh != nullptr) published_box = *fresh;
+  return published_box;
+}
+
+// Renderer<Layout> =====================================================
+template <typename Layout>
+Renderer<Layout>::Renderer(BufferType _buffer_type,
+                           RenderTarget _render_target)
+    : GeneralRenderer(_buffer_type, _render_target),
+      vbo(selectPolicy(_buffer_type), static_cast<GLenum>(_buffer_type)),
+      eao(selectPolicy(_buffer_type), static_cast<GLenum>(_buffer_type)) {}
+
+template <typename Layout>
+Renderer<Layout>::~Renderer() {
+  glFree();
+}
+
+template <typename Layout>
+void Renderer<Layout>::glUpdate() {
+  Payload* payload = mailbox.consume();
+  if (payload != nullptr) glUpload(*payload);
+}
+
+template <typename Layout>
+void Renderer<Layout>::draw(const ChunkCallback& before_chunk) {
+  glUpdate();
+
+  if (buff_generated == false) return;
+
+  glBindVertexArray(vao);
+  glAttachInstances(0, 0, false);
+
+  RenderState& state = RenderState::getInstance();
+  if (chunks.empty() == false) {  // quantized, one range per chunk
+    for (const auto& chunk : chunks) {
+      if (before_chunk) before_chunk(chunk);
+      glDrawArrays(static_cast<int>(render_target), chunk.first, chunk.count);
+      state.countDrawCall();
+    }
+    return;
   }
 
-  if (eao == 0)  // draw array
+  if (eao.id() == 0)  // draw array
     glDrawArrays(static_cast<int>(render_target), 0, vertex_count);
   else  // draw elements
-  {
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, eao);
     glDrawElements(static_cast<int>(render_target), index_count,
-                   GL_UNSIGNED_INT, (void*)0);
-  }
+                   GL_UNSIGNED_INT, (void*)eao.offset());
+  state.countDrawCall();
 }
 
-void GeneralRenderer::glMalloc() {
-  if (buff_generated == false) {
-    glGenVertexArrays(1, &vao);
-    glBindVertexArray(vao);
-    glGenBuffers(1, &vbo);
+template <typename Layout>
+void Renderer<Layout>::drawInstanced(InstanceBuffer& instances) {
+  static_assert(sizeof(CompactPose) == sizeof(float) * 8);
 
-    buff_generated = true;
-  }
+  glUpdate();
+  instances.glUpdate();
+
+  if (buff_generated == false || instances.count() == 0) return;
+
+  glBindVertexArray(vao);
+  glAttachInstances(instances.id(), instances.offset(), false);
+  glDrawInstances(instances.count());
+}
+
+template <typename Layout>
+void Renderer<Layout>::drawInstanced(const StreamBuffer& instances,
+                                     size_t count) {
+  glUpdate();
 
-  auto conditional_lock = (buffer_type == BufferType::STATIC)
-                              ? std::unique_lock<std::mutex>()
-                              : std::unique_lock<std::mutex>(mtx);
+  if (buff_generated == false || count == 0) return;
 
-  vertex_count = tmp_vertices.size();
   glBindVertexArray(vao);
-  glBindBuffer(GL_ARRAY_BUFFER, vbo);
-  glBufferData(GL_ARRAY_BUFFER, sizeof(float) * vertex_count * 3,
-               tmp_vertices.data(), static_cast<int>(buffer_type));
-  tmp_vertices.clear();
+  glAttachInstances(instances.id(), instances.offset(), true);
+  glDrawInstances(count);
+}
 
-  if (tmp_colors.empty() == false)  // not empty
-  {
-    if (cbo == 0) glGenBuffers(1, &cbo);
+// expects vao bound.
+template <typename Layout>
+void Renderer<Layout>::glDrawInstances(size_t count) {
+  if (eao.id() == 0)
+    glDrawArraysInstanced(static_cast<int>(render_target), 0, vertex_count,
+                          count);
+  else
+    glDrawElementsInstanced(static_cast<int>(render_target), index_count,
+                            GL_UNSIGNED_INT, (void*)eao.offset(), count);
+  RenderState::getInstance().countDrawCall();
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, cbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * vertex_count * 3,
-                 tmp_colors.data(), static_cast<int>(buffer_type));
-    tmp_colors.clear();
+// expects vao bound.
+template <typename Layout>
+void Renderer<Layout>::glAttachInstances(GLuint id,
+                                         size_t offset,
+                                         bool with_color) {
+  if (id == attached_instances && offset == attached_instance_offset &&
+      with_color == attached_instance_color)
+    return;
+
+  if (id == 0)
+    detachInstanceAttributes();
+  else {
+    glBindBuffer(GL_ARRAY_BUFFER, id);
+    if (with_color)
+      setupInstanceAttributesWithColor(offset);
+    else
+      setupInstanceAttributes(offset);
   }
 
-  if (tmp_scalars.empty() == false) {
-    if (sbo == 0) glGenBuffers(1, &sbo);
+  attached_instances = id;
+  attached_instance_offset = offset;
+  attached_instance_color = with_color;
+}
+
+template <typename Layout>
+void Renderer<Layout>::glUpload(Payload& payload) {
+  if (buff_generated == false) {
+    glGenVertexArrays(1, &vao);
+    buff_generated = true;
+  }
 
-    glBindBuffer(GL_ARRAY_BUFFER, sbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * vertex_count,
-                 tmp_scalars.data(), static_cast<int>(buffer_type));
-    tmp_scalars.clear();
+  if (payload.replace == false) {
+    vbo.append(payload.vertices.data(),
+               sizeof(Vertex) * payload.vertices.size());
+    vertex_count += payload.vertices.size();
+    vbo.patch(payload.patches);
+    bounding_box.extend(payload.box);
+    payload.clear();  // keeps capacity for the next tail
+    glUpdateFootprint();
+    glSetupVertexArray();
+    return;
   }
 
-  if (tmp_indices.empty() == false) {
-    if (eao == 0) glGenBuffers(1, &eao);
+  if (payload.borrow) {
+    // caller memory -> gpu storage, no staging copy in between.
+    vertex_count = payload.vertex_view.count;
+    vbo.upload(sizeof(Vertex) * vertex_count, [&](void* out) {
+      packViews<Layout>(static_cast<Vertex*>(out), payload.vertex_view,
+                        payload.color_view, payload.scalar_view,
+                        payload.chunks, payload.box);
+    });
+
+    // tail added while the borrowed update was pending
+    if (payload.vertices.empty() == false) {
+      vbo.append(payload.vertices.data(),
+                 sizeof(Vertex) * payload.vertices.size());
+      vertex_count += payload.vertices.size();
+    }
+  } else {
+    vertex_count = payload.vertices.size();
+    vbo.upload(payload.vertices.data(), sizeof(Vertex) * vertex_count);
+  }
 
-    index_count = tmp_indices.size() * 3;
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, eao);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * index_count,
-                 tmp_indices.data(), static_cast<int>(buffer_type));
-    tmp_indices.clear();
+  if (payload.indices.empty() == false) {
+    index_count = payload.indices.size() * 3;
+    eao.upload(payload.indices.data(), sizeof(unsigned int) * index_count);
   }
-}
 
-void GeneralRenderer::glFree() {
-  if (buff_generated == false) return;
+  vbo.patch(payload.patches);  // updates of the borrowed range
 
-  glDeleteBuffers(1, &vbo);
+  has_valid_color = payload.has_color;
+  has_valid_scalar = payload.has_scalar;
+  chunks = std::move(payload.chunks);
+  bounding_box = payload.box;
 
-  if (cbo != 0) glDeleteBuffers(1, &cbo);
-  if (sbo != 0) glDeleteBuffers(1, &sbo);
-  if (eao != 0) glDeleteBuffers(1, &eao);
+  payload = Payload();  // release, full uploads can be large. ends borrow.
+  glUpdateFootprint();
+  glSetupVertexArray();
+}
 
-  glDeleteVertexArrays(1, &vao);
+template <typename Layout>
+void Renderer<Layout>::glUpdateFootprint() {
+  constexpr size_t float_vertex_size =
+      sizeof(float) *
+      (3 + (Layout::has_color ? 3 : 0) + (Layout::has_scalar ? 1 : 0) +
+       (Layout::has_pose_index ? 1 : 0));
+  const size_t index_bytes = sizeof(unsigned int) * index_count;
 
-  buff_generated = false;
+  resident_bytes = sizeof(Vertex) * vertex_count + index_bytes;
+  float_bytes = float_vertex_size * vertex_count + index_bytes;
 }
 
-void GeneralRenderer::setData(std::vector<Eigen::Vector3f>&& vertices,
-                              std::vector<Eigen::Vector3f>&& colors,
-                              std::vector<float>&& scalars,
-                              std::vector<Triangle>&& indices) {
-  std::lock_guard<std::mutex> lock(mtx);
+template <typename Layout>
+void Renderer<Layout>::glSetupVertexArray() {
+  // attribute pointers only move with storage / ring slot, not per draw.
+  if (vbo.id() == attached_vbo && vbo.offset() == attached_offset &&
+      eao.id() == attached_eao)
+    return;
 
-  const size_t new_vertex_count = vertices.size();
-  const bool maintain_validity = (new_vertex_count == vertex_count);
+  glBindVertexArray(vao);
+  glBindBuffer(GL_ARRAY_BUFFER, vbo.id());
+  setupAttributes<Layout>(vbo.offset());
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, eao.id());
+  glBindVertexArray(0);
+
+  attached_vbo = vbo.id();
+  attached_offset = vbo.offset();
+  attached_eao = eao.id();
+}
 
-  tmp_vertices = std::move(vertices);
-  vertex_count = new_vertex_count;
+template <typename Layout>
+void Renderer<Layout>::glFree() {
+  if (buff_generated == false) return;
 
-  if (colors.size() == vertex_count) {
-    tmp_colors = std::move(colors);
-    has_valid_color = true;
-  } else
-    has_valid_color = has_valid_color && maintain_validity;
+  vbo.free();
+  eao.free();
 
-  if (scalars.size() == vertex_count) {
-    tmp_scalars = std::move(scalars);
-    has_valid_scalar = true;
-  } else
-    has_valid_scalar = has_valid_scalar && maintain_validity;
+  glDeleteVertexArrays(1, &vao);
 
-  // indices validity check
-  bool valid_index = true;
+  buff_generated = false;
+  vertex_count = 0;
+  index_count = 0;
+  resident_bytes = 0;
+  float_bytes = 0;
+  bounding_box.setEmpty();
+  chunks.clear();
+  attached_vbo = 0;
+  attached_offset = 0;
+  attached_eao = 0;
+  attached_instances = 0;
+  attached_instance_offset = 0;
+  attached_instance_color = false;
+}
+
+template <typename Layout>
+void Renderer<Layout>::Payload::clear() {
+  replace = false;
+  first = 0;
+  vertices.clear();
+  patches.clear();
+  indices.clear();
+  chunks.clear();
+  box.setEmpty();
+  borrow.reset();
+  vertex_view = AttributeView();
+  color_view = AttributeView();
+  scalar_view = AttributeView();
+  kept_colors.reset();
+  kept_scalars.reset();
+}
+
+template <typename Layout>
+void Renderer<Layout>::setDataImpl(const AttributeView& vertices,
+                                   const AttributeView& colors,
+                                   const AttributeView& scalars,
+                                   std::vector<Triangle>&& indices,
+                                   std::function<void()> on_release) {
+  const size_t new_vertex_count = vertices.count;
+
+  if (new_vertex_count != 0 && vertices.data == nullptr) {
+    LOG_ERROR("Renderer - Vertex view without data!");
+    throw std::invalid_argument("Vertex view without data given!");
+  }
+
+  // indices validity check, outside of any lock
   for (const auto& triangle : indices) {
     const bool current_triangle_valid =
-        (triangle.vertex_index[0] < vertex_count) &&
-        (triangle.vertex_index[1] < vertex_count) &&
-        (triangle.vertex_index[2] < vertex_count);
+        (triangle.vertex_index[0] < new_vertex_count) &&
+        (triangle.vertex_index[1] < new_vertex_count) &&
+        (triangle.vertex_index[2] < new_vertex_count);
 
     if (current_triangle_valid == false) {
-      valid_index = false;
       LOG_FATAL("Renderer - Invalid index array!");
       throw std::invalid_argument("Invalid index array given!");
     }
   }
 
-  if (valid_index) tmp_indices = std::move(indices);
+  const bool valid_color = Layout::has_color && colors.data != nullptr &&
+                           colors.count == new_vertex_count;
+  const bool valid_scalar = Layout::has_scalar && scalars.data != nullptr &&
+                            scalars.count == new_vertex_count;
+
+  // dynamic buffers keep the last colors / scalars; omitted ones carry over
+  // when the vertex count is unchanged and are packed like given ones.
+  KeptColors kept_colors;
+  KeptScalars kept_scalars;
+  if (buffer_type == BufferType::DYNAMIC) {
+    if (valid_color) kept_colors = copyColors(colors);
+    if (valid_scalar) kept_scalars = copyScalars(scalars);
+
+    std::lock_guard<std::mutex> lock(producer_mtx);
+    if (Layout::has_color && valid_color == false && producer_colors &&
+        producer_colors->size() == new_vertex_count)
+      kept_colors = producer_colors;
+    if (Layout::has_scalar && valid_scalar == false && producer_scalars &&
+        producer_scalars->size() == new_vertex_count)
+      kept_scalars = producer_scalars;
+  }
+
+  AttributeView color_view = colors, scalar_view = scalars;
+  if (valid_color == false)
+    color_view = kept_colors ? AttributeView(*kept_colors) : AttributeView();
+  if (valid_scalar == false)
+    scalar_view = kept_scalars ? AttributeView(*kept_scalars) : AttributeView();
+
+  // copying: packing runs outside of the lock; the slot is filled by moving.
+  // borrowing: the gl thread packs at upload.
+  std::vector<Vertex> packed;
+  std::vector<Chunk> packed_chunks;
+  Eigen::AlignedBox3f packed_box;
+  std::unique_ptr<Borrow> borrow;
+  if (on_release) {
+    borrow.reset(new Borrow{std::move(on_release)});
+    // packed by the gl thread, but culling needs the box now.
+    packed_box = boundsOf(vertices);
+  } else {
+    packed.resize(new_vertex_count);
+    packViews<Layout>(packed.data(), vertices, color_view, scalar_view,
+                      packed_chunks, packed_box);
+  }
+
+  std::lock_guard<std::mutex> lock(producer_mtx);
+
+  const bool maintain_validity = (new_vertex_count == producer_vertex_count);
+  producer_vertex_count = new_vertex_count;
+  producer_colors = std::move(kept_colors);
+  producer_scalars = std::move(kept_scalars);
+
+  // an unconsumed full upload may still carry indices this update omits;
+  // anything else it held is superseded. (a superseded borrow ends here)
+  const bool pending = mailbox.reclaim();
+  Payload& payload = mailbox.back();
+  const bool keep_indices = pending && payload.replace && maintain_validity;
+  std::vector<Triangle> kept_indices = std::move(payload.indices);
+  payload.clear();
+  if (keep_indices) payload.indices = std::move(kept_indices);
+
+  payload.replace = true;
+  payload.vertices = std::move(packed);
+  payload.chunks = std::move(packed_chunks);
+  payload.box = packed_box;
+  producer_box = packed_box;
+  if (indices.empty() == false) payload.indices = std::move(indices);
+  payload.has_color = color_view.empty() == false;
+  payload.has_scalar = scalar_view.empty() == false;
+
+  if (borrow) {
+    payload.first = new_vertex_count;  // a tail goes after the borrowed data
+    payload.borrow = std::move(borrow);
+    payload.vertex_view = vertices;
+    payload.color_view = color_view;
+    payload.scalar_view = scalar_view;
+    payload.kept_colors = producer_colors;
+    payload.kept_scalars = producer_scalars;
+  }
 
-  updated.store(true);
+  mailbox.publish();
+  onPublished(producer_box);
 }
 
-void GeneralRenderer::setData(std::vector<Eigen::Vector3f>&& vertices,
-                              std::vector<float>&& scalars) {
-  setData(std::move(vertices), std::vector<Eigen::Vector3f>(),
-          std::move(scalars));
+template <typename Layout>
+void Renderer<Layout>::addDataImpl(const Eigen::Vector3f* vertices,
+                                   size_t count) {
+  if constexpr (Layout::has_color || Layout::has_scalar || Layout::quantized)
+    throw std::logic_error(
+        "Renderer - addData supports float position-only layouts.");
+
+  std::lock_guard<std::mutex> lock(producer_mtx);
+
+  // unconsumed update -> extend it (full upload or tail), else new tail.
+  const bool pending = mailbox.reclaim();
+  Payload& payload = mailbox.back();
+  if (pending == false) {
+    payload.clear();
+    payload.first = producer_vertex_count;
+  }
+
+  const size_t offset = payload.vertices.size();
+  payload.vertices.resize(offset + count);
+  pack<Layout>(payload.vertices.data() + offset, vertices, nullptr, nullptr,
+               count);
+  for (size_t i = 0; i < count; i++) payload.box.extend(vertices[i]);
+  producer_box.extend(payload.box);
+  producer_vertex_count += count;
+
+  mailbox.publish();
+  onPublished(producer_box);
 }
 
-void GeneralRenderer::setData(std::vector<Eigen::Vector3f>&& vertices,
-                              std::vector<Triangle>&& indices) {
-  setData(std::move(vertices), std::vector<Eigen::Vector3f>(),
-          std::vector<float>(), std::move(indices));
+template <typename Layout>
+void Renderer<Layout>::addIndexedDataImpl(const AttributeView& vertices,
+                                          const AttributeView& scalars,
+                                          uint32_t pose_index) {
+  if constexpr (Layout::has_pose_index == false)
+    throw std::logic_error("Renderer - addData with a pose index needs an "
+                           "Indexed layout.");
+
+  if (vertices.count != 0 && vertices.data == nullptr) {
+    LOG_ERROR("Renderer - Vertex view without data!");
+    throw std::invalid_argument("Vertex view without data given!");
+  }
+  if (scalars.empty() == false && scalars.count != vertices.count) {
+    LOG_ERROR("Renderer - {} scalars for {} vertices!", scalars.count,
+              vertices.count);
+    throw std::invalid_argument("Scalars and vertices differ in size!");
+  }
+
+  // packed outside of the lock, like setData()
+  std::vector<Vertex> packed(vertices.count);
+  std::vector<Chunk> unused;
+  Eigen::AlignedBox3f box;
+  packViews<Layout>(packed.data(), vertices, AttributeView(), scalars, unused,
+                    box);
+  if constexpr (Layout::has_pose_index) {
+    for (auto& vertex : packed)
+      vertex.pose_index[0] = static_cast<float>(pose_index);
+  }
+
+  std::lock_guard<std::mutex> lock(producer_mtx);
+
+  const bool pending = mailbox.reclaim();
+  Payload& payload = mailbox.back();
+  if (pending == false) {
+    payload.clear();
+    payload.first = producer_vertex_count;
+  }
+
+  payload.vertices.insert(payload.vertices.end(), packed.begin(),
+                          packed.end());
+  payload.box.extend(box);
+  producer_box.extend(box);
+  producer_vertex_count += packed.size();
+
+  mailbox.publish();
+  onPublished(producer_box);
 }
 
-void GeneralRenderer::setData(std::vector<Eigen::Vector3f>&& vertices,
-                              std::vector<Eigen::Vector3f>&& colors,
-                              std::vector<Triangle>&& indices) {
-  setData(std::move(vertices), std::move(colors), std::vector<float>(),
-          std::move(indices));
+template <typename Layout>
+void Renderer<Layout>::updateDataImpl(const size_t* indices,
+                                      size_t first,
+                                      const Eigen::Vector3f* vertices,
+                                      size_t count) {
+  if constexpr (Layout::has_color || Layout::has_scalar || Layout::quantized)
+    throw std::logic_error(
+        "Renderer - updateData supports float position-only layouts.");
+
+  std::lock_guard<std::mutex> lock(producer_mtx);
+
+  for (size_t i = 0; i < count; i++) {
+    const size_t index = indices ? indices[i] : first + i;
+    if (index >= producer_vertex_count) {
+      LOG_ERROR("Renderer - updateData index {} out of range!", index);
+      throw std::invalid_argument("Vertex index out of range given!");
+    }
+  }
+
+  const bool pending = mailbox.reclaim();
+  Payload& payload = mailbox.back();
+  if (pending == false) {
+    payload.clear();
+    payload.first = producer_vertex_count;
+  }
+
+  // still pending on the cpu -> overwrite, otherwise patch on the gpu.
+  for (size_t i = 0; i < count; i++) {
+    const size_t index = indices ? indices[i] : first + i;
+    Vertex vertex;
+    packVertex<Layout>(vertex, vertices[i], nullptr, nullptr);
+    payload.box.extend(vertices[i]);
+    producer_box.extend(vertices[i]);
+
+    if (index >= payload.first)
+      payload.vertices[index - payload.first] = vertex;
+    else
+      payload.patches.emplace_back(index, vertex);
+  }
+
+  mailbox.publish();
+  onPublished(producer_box);
 }
 
+template class Renderer<layout::Position>;
+template class Renderer<layout::PositionColor>;
+template class Renderer<layout::PositionScalar>;
+template class Renderer<layout::PositionColorScalar>;
+template class Renderer<layout::CompactPosition>;
+template class Renderer<layout::CompactPositionColor>;
+template class Renderer<layout::CompactPositionScalar<uint8_t>>;
+template class Renderer<layout::CompactPositionScalar<Half>>;
+template class Renderer<layout::CompactPositionColorScalar<uint8_t>>;
+template class Renderer<layout::CompactPositionColorScalar<Half>>;
+template class Renderer<layout::IndexedPositionScalar>;
+
 }  // namespace gl
-}  // namespace seg
\ No newline at end of file
+}  // namespace seg
@@ -1,21 +1,35 @@
 #pragma once
 
-#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <utility>
 #include <vector>
 
 #include <Eigen/Dense>
 #include <GL/glew.h>
 
-#include "seg/types.h"  // seg::Triangle
+#include "seg/attribute_view.h"
+#include "seg/gl/stream_buffer.h"
+#include "seg/gl/vertex_layout.h"
+#include "seg/internal/triple_buffer.h"
+#include "seg/types.h"  // seg::Triangle, seg::VertexFormat
 
 typedef unsigned int GLuint;
 
 namespace seg {
+namespace core {
+class DataLatency;
+}
 namespace gl {
-class Shader;
+class InstanceBuffer;
 
+/**
+ * Layout independent renderer interface, held by GLObject.
+ * Concrete renderers are gl::Renderer<Layout>; use create() when the layout
+ * depends on which attributes the caller has.
+ */
 class GeneralRenderer {
  public:
   enum class BufferType {
@@ -30,52 +44,131 @@ class GeneralRenderer {
     TRIANGLES = GL_TRIANGLES,
   };
 
+  /**
+   * Contiguous vertex range of a quantized layout, sharing one bounding box.
+   * position = origin + scale * stored position (-1..1)
+   */
+  struct Chunk {
+    size_t first;
+    size_t count;
+    Eigen::Vector3f origin;
+    Eigen::Vector3f scale;
+
+    Eigen::Matrix4f dequantize() const;
+  };
+  using ChunkCallback = std::function<void(const Chunk&)>;
+
+  /**
+   * @brief Renderer of the layout matching the given attributes.
+   * @throw std::invalid_argument on compact formats for non point targets,
+   *        quantization reorders vertices.
+   */
+  static std::unique_ptr<GeneralRenderer> create(
+      BufferType buffer_type,
+      RenderTarget render_target,
+      bool with_color,
+      bool with_scalar,
+      VertexFormat format = VertexFormat::FLOAT);
+
  public:
   GeneralRenderer(BufferType _buffer_type, RenderTarget _render_target)
       : buffer_type(_buffer_type), render_target(_render_target) {}
-  ~GeneralRenderer();
+  virtual ~GeneralRenderer() = default;
 
-  void glFree();
+  virtual void glFree() = 0;
 
-  void draw(Shader* shader);
+  // takes pending data ahead of a draw, which does it as well.
+  virtual void glUpdate() = 0;
 
-  const bool& hasColor() const { return has_valid_color; }
-  const bool& hasScalar() const { return has_valid_scalar; }
+  void draw() { draw(ChunkCallback()); }
 
-  const size_t& vertexCount() const { return vertex_count; }
+  /**
+   * @brief Draws, calling before_chunk ahead of each chunk of a quantized
+   *        layout. The caller folds Chunk::dequantize() into the model matrix.
+   */
+  virtual void draw(const ChunkCallback& before_chunk) = 0;
 
- private:
-  void glMalloc();
+  /**
+   * @brief One draw of every transform in instances, each applied on top of
+   *        model_matrix. Also uploads pending instance updates.
+   *        Quantized layouts are not supported.
+   */
+  virtual void drawInstanced(InstanceBuffer& instances) = 0;
+  /**
+   * @brief drawInstanced() of count InstanceAttributes in instances, with
+   *        per instance scale and color.
+   */
+  virtual void drawInstanced(const StreamBuffer& instances, size_t count) = 0;
 
-  const BufferType buffer_type;
-  const RenderTarget render_target;
-  size_t vertex_count = 0;
-  size_t index_count = 0;
-
-  std::atomic<bool> updated{false};
-  std::mutex mtx;
-  std::vector<Eigen::Vector3f> tmp_vertices;
-  std::vector<Eigen::Vector3f> tmp_colors;
-  std::vector<float> tmp_scalars;
-  std::vector<Triangle> tmp_indices;
+  /**
+   * @brief Appends vertices to the end of the buffer.
+   *        Only the new tail is uploaded; GPU storage grows by doubling, so
+   *        streaming N vertices one by one costs amortized O(1) each.
+   *        Position-only layouts only.
+   */
+  void addData(const Eigen::Vector3f& vertex) { addDataImpl(&vertex, 1); }
+  void addData(const std::vector<Eigen::Vector3f>& vertices) {
+    addDataImpl(vertices.data(), vertices.size());
+  }
 
-  bool buff_generated = false;
-
-  bool has_valid_color = false;
-  bool has_valid_scalar = false;
+  /**
+   * @brief addData() for Indexed* layouts; every vertex gets pose_index.
+   *        Empty scalars are zero filled.
+   * @throw std::invalid_argument on scalars not matching the vertices.
+   */
+  void addData(const AttributeView& vertices,
+               const AttributeView& scalars,
+               uint32_t pose_index) {
+    addIndexedDataImpl(vertices, scalars, pose_index);
+  }
 
-  GLuint vao = 0;
-  GLuint vbo = 0;  // vertex buffer
-  GLuint cbo = 0;  // color buffer
-  GLuint sbo = 0;  // scalar buffer
-  GLuint eao = 0;  // element array
+  /**
+   * @brief Overwrites existing vertices in place. Only the touched ranges are
+   *        uploaded. Position-only layouts only.
+   * @throw std::invalid_argument on indices past the current vertex count.
+   */
+  void updateData(size_t index, const Eigen::Vector3f& vertex) {
+    updateDataImpl(nullptr, index, &vertex, 1);
+  }
+  void updateData(size_t first, const std::vector<Eigen::Vector3f>& vertices) {
+    updateDataImpl(nullptr, first, vertices.data(), vertices.size());
+  }
+  void updateData(const std::vector<size_t>& indices,
+                  const std::vector<Eigen::Vector3f>& vertices);
 
- public:
+  /**
+   * @brief Replaces buffer contents. Never waits on the gl thread; an update
+   *        not yet picked up by the gl thread is superseded (latest wins).
+   *        Colors / scalars / indices the caller omits keep the previous
+   *        ones when the vertex count is unchanged (colors / scalars on
+   *        DYNAMIC buffers only, which keep a copy of the last ones set),
+   *        otherwise colors / scalars are zero filled.
+   * @throw std::invalid_argument on out of range triangle indices.
+   */
   void setData(
       std::vector<Eigen::Vector3f>&& vertices,
       std::vector<Eigen::Vector3f>&& colors = std::vector<Eigen::Vector3f>(),
       std::vector<float>&& scalars = std::vector<float>(),
-      std::vector<Triangle>&& indices = std::vector<Triangle>());
+      std::vector<Triangle>&& indices = std::vector<Triangle>()) {
+    setDataImpl(vertices, colors, scalars, std::move(indices), nullptr);
+  }
+
+  /**
+   * @brief setData() from strided views, converted to the layout while
+   *        packing; no intermediate copies of the caller's data.
+   * @param on_release - empty: views are packed before returning.
+   *        otherwise the memory is borrowed and packed straight into gpu
+   *        storage by the gl thread. on_release is called once it is not
+   *        read anymore (uploaded, superseded or freed), from either thread.
+   */
+  void setData(const AttributeView& vertices,
+               const AttributeView& colors,
+               const AttributeView& scalars,
+               std::vector<Triangle>&& indices = std::vector<Triangle>(),
+               std::function<void()> on_release = nullptr) {
+    setDataImpl(vertices, colors, scalars, std::move(indices),
+                std::move(on_release));
+  }
 
   void setData(std::vector<Eigen::Vector3f>&& vertices,
                std::vector<float>&& scalars);
@@ -85,6 +178,171 @@ class GeneralRenderer {
   void setData(std::vector<Eigen::Vector3f>&& vertices,
                std::vector<Eigen::Vector3f>&& colors,
                std::vector<Triangle>&& indices);
+
+  const bool& hasColor() const { return has_valid_color; }
+  const bool& hasScalar() const { return has_valid_scalar; }
+  RenderTarget getRenderTarget() const { return render_target; }
+
+  // data changes are stamped to latency, the owning object's. set it first.
+  void setLatency(core::DataLatency* _latency) { latency = _latency; }
+
+  // gl thread view: what is currently resident on the gpu.
+  const size_t& vertexCount() const { return vertex_count; }
+  const size_t& residentBytes() const { return resident_bytes; }
+  // same vertices in 32 bit float attributes.
+  const size_t& floatBytes() const { return float_bytes; }
+  // of the resident vertices, before the model matrix. grows on updateData().
+  const Eigen::AlignedBox3f& bounds() const { return bounding_box; }
+  /**
+   * @brief gl thread: bounds() of the newest data set, uploaded or not.
+   *        What culling tests, so an object moving into view is drawn and
+   *        takes its pending data.
+   */
+  const Eigen::AlignedBox3f& glBounds();
+
+ protected:
+  virtual void addDataImpl(const Eigen::Vector3f* vertices, size_t count) = 0;
+  virtual void addIndexedDataImpl(const AttributeView& vertices,
+                                  const AttributeView& scalars,
+                                  uint32_t pose_index) = 0;
+  // indices == nullptr -> first, first + 1, ...
+  virtual void updateDataImpl(const size_t* indices,
+                              size_t first,
+                              const Eigen::Vector3f* vertices,
+                              size_t count) = 0;
+  virtual void setDataImpl(const AttributeView& vertices,
+                           const AttributeView& colors,
+                           const AttributeView& scalars,
+                           std::vector<Triangle>&& indices,
+                           std::function<void()> on_release) = 0;
+
+  // producer side, after a payload is published. box - of all the data now.
+  void onPublished(const Eigen::AlignedBox3f& box);
+
+  const BufferType buffer_type;
+  core::DataLatency* latency = nullptr;
+  const RenderTarget render_target;
+
+  // gl thread side
+  size_t vertex_count = 0;  // resident on gpu
+  size_t index_count = 0;
+  bool has_valid_color = false;
+  bool has_valid_scalar = false;
+  size_t resident_bytes = 0;
+  size_t float_bytes = 0;
+  Eigen::AlignedBox3f bounding_box;
+
+ private:
+  TripleBuffer<Eigen::AlignedBox3f> box_mailbox;  // published by producers
+  Eigen::AlignedBox3f published_box;              // gl thread
+
 };  // class GeneralRenderer
+
+/**
+ * Renderer over one interleaved vertex buffer of gl::layout::*.
+ * The vao is configured when storage (or its ring slot) changes, so a draw
+ * is a vao bind and a draw call.
+ * Instantiated for the layouts in vertex_layout.h. (general_renderer.cpp)
+ */
+template <typename Layout>
+class Renderer : public GeneralRenderer {
+ public:
+  using Vertex = typename Layout::Vertex;
+
+  Renderer(BufferType _buffer_type, RenderTarget _render_target);
+  ~Renderer() override;
+
+  using GeneralRenderer::draw;
+
+  void glFree() override;
+  void glUpdate() override;
+  void draw(const ChunkCallback& before_chunk) override;
+  void drawInstanced(InstanceBuffer& instances) override;
+  void drawInstanced(const StreamBuffer& instances, size_t count) override;
+
+ protected:
+  void addDataImpl(const Eigen::Vector3f* vertices, size_t count) override;
+  void addIndexedDataImpl(const AttributeView& vertices,
+                          const AttributeView& scalars,
+                          uint32_t pose_index) override;
+  void updateDataImpl(const size_t* indices,
+                      size_t first,
+                      const Eigen::Vector3f* vertices,
+                      size_t count) override;
+  void setDataImpl(const AttributeView& vertices,
+                   const AttributeView& colors,
+                   const AttributeView& scalars,
+                   std::vector<Triangle>&& indices,
+                   std::function<void()> on_release) override;
+
+ private:
+  // calls on_release when destroyed, i.e. when its payload is dropped.
+  struct Borrow {
+    std::function<void()> on_release;
+    ~Borrow() {
+      if (on_release) on_release();
+    }
+  };
+
+  // last colors / scalars set, as packing reads them. immutable once set.
+  using KeptColors = std::shared_ptr<const std::vector<Eigen::Vector3f>>;
+  using KeptScalars = std::shared_ptr<const std::vector<float>>;
+
+  // one pending update, handed from producers to the gl thread.
+  struct Payload {
+    bool replace = false;  // full upload, otherwise appended tail
+    bool has_color = false;
+    bool has_scalar = false;
+    size_t first = 0;              // vertex index of vertices[0]
+    std::vector<Vertex> vertices;  // packed on the producer side
+    std::vector<std::pair<size_t, Vertex>> patches;  // below first
+    std::vector<Triangle> indices;
+    std::vector<Chunk> chunks;  // quantized layouts only
+    Eigen::AlignedBox3f box;    // of every vertex written by this payload
+
+    // borrowed caller memory, packed on the gl thread ahead of vertices.
+    std::unique_ptr<Borrow> borrow;
+    AttributeView vertex_view;
+    AttributeView color_view;
+    AttributeView scalar_view;
+    // kept attributes the views may point into
+    KeptColors kept_colors;
+    KeptScalars kept_scalars;
+
+    void clear();
+  };
+
+  void glUpload(Payload& payload);
+  void glSetupVertexArray();
+  void glUpdateFootprint();
+  // id 0 detaches. with_color - InstanceAttributes, else CompactPose.
+  void glAttachInstances(GLuint id, size_t offset, bool with_color);
+  void glDrawInstances(size_t count);
+
+  // producer side, guarded by producer_mtx. gl thread never locks it.
+  std::mutex producer_mtx;
+  size_t producer_vertex_count = 0;
+  Eigen::AlignedBox3f producer_box;  // of every vertex set since setData()
+  KeptColors producer_colors;          // DYNAMIC only
+  KeptScalars producer_scalars;
+  TripleBuffer<Payload> mailbox;
+
+  // gl thread side
+  bool buff_generated = false;
+
+  GLuint vao = 0;
+  StreamBuffer vbo;  // interleaved vertex buffer
+  StreamBuffer eao;  // element array
+  std::vector<Chunk> chunks;
+
+  // storage the vao currently points at
+  GLuint attached_vbo = 0;
+  size_t attached_offset = 0;
+  GLuint attached_eao = 0;
+  GLuint attached_instances = 0;
+  size_t attached_instance_offset = 0;
+  bool attached_instance_color = false;
+
+};  // class Renderer
 }  // namespace gl
 }  // namespace seg
@@ -0,0 +1,107 @@
+#include "seg/gl/geometry_cache.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "seg/internal/logger.h"
+
+static std::once_flag instance_flag;
+static std::unique_ptr<seg::gl::GeometryCache> cache;
+
+namespace seg {
+namespace gl {
+namespace {
+void appendBytes(std::vector<unsigned char>& out,
+                 const void* data,
+                 size_t bytes) {
+  const auto* begin = static_cast<const unsigned char*>(data);
+  out.insert(out.end(), begin, begin + bytes);
+}
+
+template <typename T>
+void appendVector(std::vector<unsigned char>& out, const std::vector<T>& in) {
+  const uint64_t count = in.size();
+  appendBytes(out, &count, sizeof(count));
+  appendBytes(out, in.data(), sizeof(T) * in.size());
+}
+
+// FNV-1a
+uint64_t hashBytes(const std::vector<unsigned char>& bytes) {
+  uint64_t hash = 14695981039346656037ull;
+  for (const unsigned char byte : bytes) {
+    hash ^= byte;
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+}  // namespace
+
+GeometryCache& GeometryCache::getInstance() {
+  std::call_once(instance_flag, [] { cache.reset(new GeometryCache()); });
+
+  return *(cache.get());
+}
+
+std::shared_ptr<GeneralRenderer> GeometryCache::acquire(
+    GeneralRenderer::RenderTarget target,
+    const std::vector<Eigen::Vector3f>& vertices,
+    const std::vector<Eigen::Vector3f>& colors,
+    const std::vector<Triangle>& triangles) {
+  if (vertices.empty() || vertices.size() > MAX_VERTICES) return nullptr;
+  const bool with_color = colors.size() == vertices.size();
+
+  std::vector<unsigned char> key;
+  const int target_value = static_cast<int>(target);
+  appendBytes(key, &target_value, sizeof(target_value));
+  appendVector(key, vertices);
+  appendVector(key, with_color ? colors : std::vector<Eigen::Vector3f>());
+  appendVector(key, triangles);
+  const uint64_t hash = hashBytes(key);
+
+  std::lock_guard<std::mutex> lock(mtx);
+  auto range = entries.equal_range(hash);
+  for (auto iter = range.first; iter != range.second; ++iter)
+    if (iter->second.key == key) return iter->second.renderer;
+
+  std::shared_ptr<GeneralRenderer> renderer = GeneralRenderer::create(
+      GeneralRenderer::BufferType::STATIC, target, with_color, false);
+  std::vector<Triangle> indices = triangles;  // clone
+  renderer->setData(AttributeView(vertices),
+                    with_color ? AttributeView(colors) : AttributeView(),
+                    AttributeView(), std::move(indices));
+
+  entries.emplace(hash, Entry{std::move(key), renderer});
+  return renderer;
+}
+
+size_t GeometryCache::size() {
+  std::lock_guard<std::mutex> lock(mtx);
+  return entries.size();
+}
+
+void GeometryCache::glCollect() {
+  std::lock_guard<std::mutex> lock(mtx);
+  for (auto iter = entries.begin(); iter != entries.end();) {
+    // copies are only made under mtx, so 1 stays 1.
+    if (iter->second.renderer.use_count() == 1) {
+      iter->second.renderer->glFree();
+      iter = entries.erase(iter);
+    } else
+      ++iter;
+  }
+}
+
+void GeometryCache::glClear() {
+  std::lock_guard<std::mutex> lock(mtx);
+  for (auto& entry : entries) entry.second.renderer->glFree();
+  if (entries.empty() == false)
+    LOG_DEBUG("GeometryCache - {} entries freed.", entries.size());
+  entries.clear();
+}
+
+}  // namespace gl
+}  // namespace seg
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "seg/gl/general_renderer.h"
+#include "seg/types.h"  // seg::Triangle
+
+namespace seg {
+namespace gl {
+/**
+ * Static geometry by content, so identical meshes / markers are uploaded
+ * once and share one renderer, which also lets ObjectManager draw them as
+ * instances of each other.
+ * acquire() runs on any thread; entries nobody holds anymore are freed by
+ * glCollect() on the gl thread.
+ */
+class GeometryCache {
+ public:
+  // larger geometry is rarely repeated, and not worth keeping a copy of.
+  static const size_t MAX_VERTICES = 65536;
+
+  static GeometryCache& getInstance();
+
+  /**
+   * @brief Shared STATIC renderer holding the geometry, colors given if
+   *        they match the vertices.
+   * @return nullptr over MAX_VERTICES, the caller keeps its own renderer.
+   */
+  std::shared_ptr<GeneralRenderer> acquire(
+      GeneralRenderer::RenderTarget target,
+      const std::vector<Eigen::Vector3f>& vertices,
+      const std::vector<Eigen::Vector3f>& colors =
+          std::vector<Eigen::Vector3f>(),
+      const std::vector<Triangle>& triangles = std::vector<Triangle>());
+
+  size_t size();
+
+  // gl thread side =================================================
+  // frees geometry only the cache holds.
+  void glCollect();
+  // frees everything, at shutdown once objects are freed.
+  void glClear();
+
+ private:
+  GeometryCache() {}
+
+  struct Entry {
+    std::vector<unsigned char> key;  // target, sizes and contents
+    std::shared_ptr<GeneralRenderer> renderer;
+  };
+
+  std::mutex mtx;
+  std::unordered_multimap<uint64_t, Entry> entries;  // by hash of key
+
+};  // class GeometryCache
+}  // namespace gl
+}  // namespace seg
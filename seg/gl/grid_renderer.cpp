@@ -4,6 +4,7 @@
 #include <GLFW/glfw3.h>
 
 #include "seg/core/config.h"
+#include "seg/gl/render_state.h"
 #include "seg/gl/shader.h"
 
 namespace seg {
@@ -19,17 +20,17 @@ GridRenderer::~GridRenderer() { glDeleteVertexArrays(1, &vao); }
 void GridRenderer::drawImpl() {
   if (getConfig().show_grid == false) return;
 
-  glEnable(GL_DEPTH_TEST);
-  glDepthFunc(GL_LESS);
-  glEnable(GL_BLEND);
-  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  RenderState& state = RenderState::getInstance();
+  state.setDepthTest(true, GL_LESS);
+  state.setBlend(true);
 
   shader->bind();
-  shader->setUniform("grid_color", grid_color.asEigenVector4f());
-  shader->setUniform("grid_fade_distance", fade_distance);
+  shader->setUniform(Uniform::GRID_COLOR, grid_color.asEigenVector4f());
+  shader->setUniform(Uniform::GRID_FADE_DISTANCE, fade_distance);
 
   glBindVertexArray(vao);
   glDrawArrays(GL_TRIANGLES, 0, 6);
+  state.countDrawCall();
   glBindVertexArray(0);
 }
 
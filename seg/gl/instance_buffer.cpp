@@ -0,0 +1,116 @@
+#include "seg/gl/instance_buffer.h"
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "seg/core/config.h"
+#include "seg/core/frame_request.h"
+
+namespace seg {
+namespace gl {
+InstanceBuffer::InstanceBuffer() : InstanceBuffer(getConfig().upload_policy) {}
+
+InstanceBuffer::InstanceBuffer(UploadPolicy policy)
+    : buffer(policy, GL_STREAM_DRAW) {}
+
+InstanceBuffer::~InstanceBuffer() { glFree(); }
+
+void InstanceBuffer::add(const CompactPose& pose) {
+  std::lock_guard<std::mutex> lock(producer_mtx);
+
+  reclaimPayload().poses.push_back(pose);
+  producer_count++;
+  mailbox.publish();
+  FrameRequest::request();
+}
+
+void InstanceBuffer::set(std::vector<CompactPose>&& poses) {
+  std::lock_guard<std::mutex> lock(producer_mtx);
+
+  mailbox.reclaim();  // superseded either way
+  Payload& payload = mailbox.back();
+  payload.clear();
+  payload.replace = true;
+  payload.poses = std::move(poses);
+  producer_count = payload.poses.size();
+  mailbox.publish();
+  FrameRequest::request();
+}
+
+void InstanceBuffer::update(size_t first,
+                            const std::vector<CompactPose>& poses) {
+  updateImpl(nullptr, first, poses.data(), poses.size());
+}
+
+void InstanceBuffer::update(const std::vector<size_t>& indices,
+                            const std::vector<CompactPose>& poses) {
+  updateImpl(indices.data(), 0, poses.data(),
+             std::min(indices.size(), poses.size()));
+}
+
+void InstanceBuffer::updateImpl(const size_t* indices,
+                                size_t first,
+                                const CompactPose* poses,
+                                size_t count) {
+  std::lock_guard<std::mutex> lock(producer_mtx);
+  Payload& payload = reclaimPayload();
+
+  for (size_t i = 0; i < count; i++) {
+    const size_t index = indices ? indices[i] : first + i;
+    if (index >= producer_count) continue;
+
+    // still pending on the cpu -> overwrite, otherwise patch on the gpu.
+    if (index >= payload.first)
+      payload.poses[index - payload.first] = poses[i];
+    else
+      payload.patches.emplace_back(index, poses[i]);
+  }
+
+  mailbox.publish();
+  FrameRequest::request();
+}
+
+InstanceBuffer::Payload& InstanceBuffer::reclaimPayload() {
+  const bool pending = mailbox.reclaim();
+  Payload& payload = mailbox.back();
+  if (pending == false) {
+    payload.clear();
+    payload.first = producer_count;
+  }
+  return payload;
+}
+
+void InstanceBuffer::Payload::clear() {
+  replace = false;
+  first = 0;
+  poses.clear();
+  patches.clear();
+}
+
+void InstanceBuffer::glUpdate() {
+  Payload* payload = mailbox.consume();
+  if (payload == nullptr) return;
+
+  const size_t bytes = sizeof(CompactPose) * payload->poses.size();
+  if (payload->replace) {
+    buffer.upload(payload->poses.data(), bytes);
+    instance_count = payload->poses.size();
+  } else if (bytes != 0) {
+    buffer.append(payload->poses.data(), bytes);
+    instance_count += payload->poses.size();
+  }
+
+  buffer.patch(payload->patches);
+  payload->clear();  // keeps capacity for the next tail
+}
+
+void InstanceBuffer::glFree() {
+  buffer.free();
+  instance_count = 0;
+}
+
+}  // namespace gl
+}  // namespace seg
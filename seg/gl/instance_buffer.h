@@ -0,0 +1,74 @@
+#pragma once
+
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Dense>
+#include <GL/glew.h>
+
+#include "seg/gl/stream_buffer.h"
+#include "seg/internal/triple_buffer.h"
+#include "seg/types.h"  // seg::CompactPose
+
+namespace seg {
+namespace gl {
+/**
+ * Per-instance poses for Renderer::drawInstanced().
+ * Producers add / set / update poses from any thread without waiting on the
+ * gl thread; appended poses upload only the new tail, updated poses only
+ * their dirty ranges.
+ */
+class InstanceBuffer {
+ public:
+  InstanceBuffer();
+  explicit InstanceBuffer(UploadPolicy policy);
+  ~InstanceBuffer();
+  InstanceBuffer(const InstanceBuffer&) = delete;
+  InstanceBuffer& operator=(const InstanceBuffer&) = delete;
+
+  // producer side ==================================================
+  void add(const CompactPose& pose);
+  void set(std::vector<CompactPose>&& poses);
+  // overwrites existing poses; indices past the current count are skipped.
+  void update(size_t first, const std::vector<CompactPose>& poses);
+  void update(const std::vector<size_t>& indices,
+              const std::vector<CompactPose>& poses);
+
+  // gl thread side =================================================
+  // uploads pending updates, once per frame is enough.
+  void glUpdate();
+  void glFree();
+
+  GLuint id() const { return buffer.id(); }
+  size_t offset() const { return buffer.offset(); }
+  const size_t& count() const { return instance_count; }
+
+ private:
+  struct Payload {
+    bool replace = false;  // full upload, otherwise appended tail
+    size_t first = 0;      // instance index of poses[0]
+    std::vector<CompactPose> poses;
+    std::vector<std::pair<size_t, CompactPose>> patches;  // below first
+
+    void clear();
+  };
+
+  // reclaims the pending payload, or starts a tail at the current count.
+  Payload& reclaimPayload();
+  // indices == nullptr -> first, first + 1, ...
+  void updateImpl(const size_t* indices,
+                  size_t first,
+                  const CompactPose* poses,
+                  size_t count);
+
+  std::mutex producer_mtx;
+  size_t producer_count = 0;
+  TripleBuffer<Payload> mailbox;
+
+  StreamBuffer buffer;
+  size_t instance_count = 0;
+
+};  // class InstanceBuffer
+}  // namespace gl
+}  // namespace seg
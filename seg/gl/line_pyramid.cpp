@@ -0,0 +1,216 @@
+#include "seg/gl/line_pyramid.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "seg/gl/vertex_layout.h"
+#include "seg/internal/logger.h"
+
+namespace seg {
+namespace gl {
+LinePyramid::LinePyramid() {
+  for (auto& level : levels)
+    level.reset(new Renderer<layout::Position>(
+        GeneralRenderer::BufferType::DYNAMIC,
+        GeneralRenderer::RenderTarget::LINE_STRIP));
+}
+
+LinePyramid::~LinePyramid() {}
+
+size_t LinePyramid::levelCount(int level, size_t count) {
+  if (count == 0) return 0;
+
+  const size_t last = count - 1;
+  const size_t mask = (size_t(1) << level) - 1;
+  return (last >> level) + 1 + ((last & mask) != 0);
+}
+
+void LinePyramid::add(const Eigen::Vector3f& vertex) {
+  const size_t index = vertex_count;
+
+  for (int k = 0; k < NUM_LEVELS; k++) {
+    const size_t mask = (size_t(1) << k) - 1;
+
+    // the previous last vertex was kept -> new tail, else move the tail.
+    if (index == 0 || ((index - 1) & mask) == 0)
+      levels[k]->addData(vertex);
+    else
+      levels[k]->updateData(levelCount(k, index) - 1, vertex);
+  }
+
+  extendBlocks(index, vertex);
+  bounds.box.extend(vertex);
+  vertex_count++;
+  publishBounds();
+}
+
+void LinePyramid::set(const std::vector<Eigen::Vector3f>& vertices) {
+  vertex_count = vertices.size();
+  bounds = Bounds();
+  for (auto& level_blocks : blocks) level_blocks.clear();
+
+  for (size_t i = 0; i < vertices.size(); i++) {
+    extendBlocks(i, vertices[i]);
+    bounds.box.extend(vertices[i]);
+  }
+
+  levels[0]->setData(AttributeView(vertices), AttributeView(),
+                     AttributeView());
+
+  for (int k = 1; k < NUM_LEVELS; k++) {
+    const size_t step = size_t(1) << k;
+
+    std::vector<Eigen::Vector3f> decimated;
+    decimated.reserve(levelCount(k, vertex_count));
+    for (size_t i = 0; i < vertex_count; i += step)
+      decimated.push_back(vertices[i]);
+    if (vertex_count != 0 && ((vertex_count - 1) % step) != 0)
+      decimated.push_back(vertices.back());
+
+    levels[k]->setData(std::move(decimated));
+  }
+
+  publishBounds();
+}
+
+void LinePyramid::update(size_t first,
+                         const std::vector<Eigen::Vector3f>& vertices) {
+  updateImpl(nullptr, first, vertices.data(), vertices.size());
+}
+
+void LinePyramid::update(const std::vector<size_t>& indices,
+                         const std::vector<Eigen::Vector3f>& vertices) {
+  if (indices.size() != vertices.size()) {
+    LOG_ERROR("LinePyramid - update size mismatch!");
+    throw std::invalid_argument("Indices and vertices differ in size!");
+  }
+  updateImpl(indices.data(), 0, vertices.data(), vertices.size());
+}
+
+void LinePyramid::updateImpl(const size_t* indices,
+                             size_t first,
+                             const Eigen::Vector3f* vertices,
+                             size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    const size_t index = indices ? indices[i] : first + i;
+    if (index >= vertex_count) {
+      LOG_ERROR("LinePyramid - update index {} out of range!", index);
+      throw std::invalid_argument("Vertex index out of range given!");
+    }
+  }
+
+  std::vector<size_t> level_indices[NUM_LEVELS];
+  std::vector<Eigen::Vector3f> level_vertices[NUM_LEVELS];
+
+  for (size_t i = 0; i < count; i++) {
+    const size_t index = indices ? indices[i] : first + i;
+
+    for (int k = 0; k < NUM_LEVELS; k++) {
+      const size_t mask = (size_t(1) << k) - 1;
+
+      size_t level_index;
+      if ((index & mask) == 0)
+        level_index = index >> k;
+      else if (index + 1 == vertex_count)  // tail
+        level_index = levelCount(k, vertex_count) - 1;
+      else
+        continue;
+
+      level_indices[k].push_back(level_index);
+      level_vertices[k].push_back(vertices[i]);
+    }
+
+    extendBlocks(index, vertices[i]);
+    bounds.box.extend(vertices[i]);
+  }
+
+  for (int k = 0; k < NUM_LEVELS; k++) {
+    if (level_indices[k].empty()) continue;
+    levels[k]->updateData(level_indices[k], level_vertices[k]);
+  }
+
+  publishBounds();
+}
+
+void LinePyramid::extendBlocks(size_t index, const Eigen::Vector3f& vertex) {
+  // block j of level k spans vertices [j * 2^k, (j + 1) * 2^k]; the ends
+  // are shared, so a kept vertex also closes the block before it.
+  for (int k = 1; k < NUM_LEVELS; k++) {
+    const size_t mask = (size_t(1) << k) - 1;
+    const size_t block = index >> k;
+
+    auto& level_blocks = blocks[k];
+    if (level_blocks.size() <= block) level_blocks.resize(block + 1);
+
+    level_blocks[block].extend(vertex);
+    bounds.error[k] =
+        std::max(bounds.error[k], level_blocks[block].diagonal().norm());
+
+    if ((index & mask) == 0 && block != 0) {
+      level_blocks[block - 1].extend(vertex);
+      bounds.error[k] = std::max(bounds.error[k],
+                                 level_blocks[block - 1].diagonal().norm());
+    }
+  }
+}
+
+void LinePyramid::publishBounds() {
+  mailbox.back() = bounds;
+  mailbox.publish();
+}
+
+void LinePyramid::glConsumeBounds() {
+  Bounds* fresh = mailbox.consume();
+  if (fresh != nullptr) gl_bounds = *fresh;
+}
+
+const Eigen::AlignedBox3f& LinePyramid::glBounds() {
+  glConsumeBounds();
+  return gl_bounds.box;
+}
+
+int LinePyramid::selectLevel(const View& view,
+                             const Eigen::Matrix4f& model_matrix,
+                             float tolerance_px) {
+  glConsumeBounds();
+
+  const auto& box = gl_bounds.box;
+  if (box.isEmpty()) return 0;
+
+  // clip w is linear in position -> its minimum is at a corner.
+  const Eigen::RowVector4f w_row = view.vp_matrix.row(3) * model_matrix;
+  float min_w = std::numeric_limits<float>::max();
+  for (int c = 0; c < 8; c++) {
+    const Eigen::Vector3f corner =
+        box.corner(static_cast<Eigen::AlignedBox3f::CornerType>(c));
+    min_w = std::min(min_w, w_row.dot(corner.homogeneous()));
+  }
+  if (min_w <= 0.0f) return 0;  // camera inside the box
+
+  const float scale =
+      model_matrix.topLeftCorner<3, 3>().colwise().norm().maxCoeff();
+  if (scale <= 0.0f) return 0;
+
+  // errors grow with the level, block k + 1 holds two blocks of k.
+  const float max_error = tolerance_px * view.pixelSize(min_w) / scale;
+  int level = 0;
+  while (level + 1 < NUM_LEVELS && gl_bounds.error[level + 1] <= max_error)
+    level++;
+
+  return level;
+}
+
+void LinePyramid::draw(int level) {
+  levels[std::clamp(level, 0, NUM_LEVELS - 1)]->draw();
+}
+
+void LinePyramid::glFree() {
+  for (auto& level : levels) level->glFree();
+}
+
+}  // namespace gl
+}  // namespace seg
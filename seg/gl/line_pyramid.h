@@ -0,0 +1,87 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "seg/gl/general_renderer.h"
+#include "seg/gl/view.h"
+#include "seg/internal/triple_buffer.h"
+
+namespace seg {
+namespace gl {
+/**
+ * Line strip kept at power of two decimations, built incrementally.
+ * Level k holds every 2^k-th vertex plus the last one. A min/max pyramid of
+ * block bounding boxes bounds how far level k strays from the full strip,
+ * so a frame draws the coarsest level whose error stays under a pixel.
+ *
+ * Producer calls (add / set / update) must be serialized by the caller.
+ */
+class LinePyramid {
+ public:
+  static const int NUM_LEVELS = 17;  // top level keeps 1 of 65536
+
+  LinePyramid();
+  ~LinePyramid();
+  LinePyramid(const LinePyramid&) = delete;
+  LinePyramid& operator=(const LinePyramid&) = delete;
+
+  // producer side ==================================================
+  void add(const Eigen::Vector3f& vertex);
+  void set(const std::vector<Eigen::Vector3f>& vertices);
+  // overwrites existing vertices; the error bound only grows.
+  void update(size_t first, const std::vector<Eigen::Vector3f>& vertices);
+  void update(const std::vector<size_t>& indices,
+              const std::vector<Eigen::Vector3f>& vertices);
+
+  // gl thread side =================================================
+  /**
+   * @return coarsest level off the full strip by at most tolerance pixels
+   *         anywhere, judged at the nearest corner of the bounding box.
+   */
+  int selectLevel(const View& view,
+                  const Eigen::Matrix4f& model_matrix,
+                  float tolerance_px);
+  void draw(int level);
+  void glFree();
+  // of every vertex, before the model matrix.
+  const Eigen::AlignedBox3f& glBounds();
+
+  const size_t& vertexCount(int level) const {
+    return levels[level]->vertexCount();
+  }
+
+ private:
+  struct Bounds {
+    Eigen::AlignedBox3f box;       // of every vertex
+    float error[NUM_LEVELS] = {};  // max block diagonal per level
+  };
+
+  // vertex count of level k for count vertices in total
+  static size_t levelCount(int level, size_t count);
+  // grows the blocks holding vertex index, level >= 1
+  void extendBlocks(size_t index, const Eigen::Vector3f& vertex);
+  void publishBounds();
+  void glConsumeBounds();
+  void updateImpl(const size_t* indices,
+                  size_t first,
+                  const Eigen::Vector3f* vertices,
+                  size_t count);
+
+  // producer side
+  size_t vertex_count = 0;
+  std::vector<Eigen::AlignedBox3f> blocks[NUM_LEVELS];  // [0] unused
+  Bounds bounds;
+  TripleBuffer<Bounds> mailbox;
+
+  // filled by producers, drawn by the gl thread
+  std::unique_ptr<GeneralRenderer> levels[NUM_LEVELS];
+
+  // gl thread side
+  Bounds gl_bounds;
+
+};  // class LinePyramid
+}  // namespace gl
+}  // namespace seg
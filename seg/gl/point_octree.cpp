@@ -0,0 +1,387 @@
+#include "seg/gl/point_octree.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "seg/core/frame_request.h"
+#include "seg/gl/vertex_layout.h"
+#include "seg/internal/logger.h"
+
+namespace seg {
+namespace gl {
+namespace {
+std::vector<Eigen::Vector3f> copyVectors(const AttributeView& view) {
+  std::vector<Eigen::Vector3f> out(view.count);
+  visitType(view, [&](auto t) {
+    for (size_t i = 0; i < view.count; i++)
+      out[i] = readVector3<decltype(t)>(view, i);
+  });
+  return out;
+}
+
+std::vector<float> copyScalars(const AttributeView& view) {
+  std::vector<float> out(view.count);
+  visitType(view, [&](auto t) {
+    for (size_t i = 0; i < view.count; i++)
+      out[i] = static_cast<float>(*element<decltype(t)>(view, i));
+  });
+  return out;
+}
+
+template <typename T>
+void reorder(std::vector<T>& values, const std::vector<uint32_t>& order) {
+  if (values.empty()) return;
+
+  std::vector<T> sorted(order.size());
+  for (size_t i = 0; i < order.size(); i++) sorted[i] = values[order[i]];
+  values.swap(sorted);
+}
+
+// child cell of box, octant bits x | y << 1 | z << 2 set -> upper half.
+Eigen::AlignedBox3f octantBox(const Eigen::AlignedBox3f& box, int octant) {
+  const Eigen::Vector3f center = box.center();
+  Eigen::AlignedBox3f out = box;
+  for (int k = 0; k < 3; k++) {
+    if (octant & (1 << k))
+      out.min()[k] = center[k];
+    else
+      out.max()[k] = center[k];
+  }
+  return out;
+}
+}  // namespace
+
+PointOctree::PointOctree(const AttributeView& vertices,
+                         const AttributeView& _colors,
+                         const AttributeView& _scalars,
+                         VertexFormat _format)
+    : format(_format) {
+  if (vertices.empty() || vertices.data == nullptr)
+    throw std::invalid_argument("PointOctree - Given Vertices empty.");
+  if (vertices.count > std::numeric_limits<uint32_t>::max())
+    throw std::invalid_argument("PointOctree - Over 2^32 points given.");
+
+  point_count = vertices.count;
+  positions = copyVectors(vertices);
+  if (_colors.count == vertices.count && _colors.data != nullptr)
+    colors = copyVectors(_colors);
+  if (_scalars.count == vertices.count && _scalars.data != nullptr)
+    scalars = copyScalars(_scalars);
+  has_color = colors.empty() == false;
+  has_scalar = scalars.empty() == false;
+
+  loader = std::thread([this] { loaderLoop(); });
+}
+
+PointOctree::~PointOctree() {
+  {
+    std::lock_guard<std::mutex> lock(request_mtx);
+    stop = true;
+  }
+  request_cv.notify_one();
+  loader.join();
+
+  glFree();
+}
+
+// loader thread ======================================================
+void PointOctree::loaderLoop() {
+  build();
+  if (stop) return;
+  FrameRequest::request();  // drawable from now on
+
+  while (true) {
+    uint32_t index;
+    {
+      std::unique_lock<std::mutex> lock(request_mtx);
+      request_cv.wait(lock,
+                      [this] { return stop || requests.empty() == false; });
+      if (stop) return;
+
+      index = requests.front();
+      requests.pop_front();
+    }
+
+    Node& node = nodes[index];
+    int expected = UNLOADED;
+    if (node.state.compare_exchange_strong(expected, LOADING) == false)
+      continue;  // requested twice
+
+    load(node);
+    node.state.store(LOADED, std::memory_order_release);
+
+    std::lock_guard<std::mutex> lock(request_mtx);
+    loaded.push_back(index);
+  }
+}
+
+void PointOctree::build() {
+  const auto begin = std::chrono::steady_clock::now();
+
+  // a random order makes the first points of any cell a uniform subsample.
+  std::vector<uint32_t> order(point_count);
+  std::iota(order.begin(), order.end(), 0);
+  std::shuffle(order.begin(), order.end(), std::mt19937(42));
+  std::vector<uint32_t> scratch(point_count);
+
+  Eigen::AlignedBox3f box;
+  for (const auto& position : positions) box.extend(position);
+  const Eigen::Vector3f half =
+      Eigen::Vector3f::Constant(box.sizes().maxCoeff() * 0.5f + 1e-3f);
+
+  nodes.emplace_back();
+  nodes[0].box = Eigen::AlignedBox3f(box.center() - half, box.center() + half);
+  buildNode(0, order, scratch, 0, point_count, 0);
+  if (stop) return;
+
+  reorder(positions, order);
+  reorder(colors, order);
+  reorder(scalars, order);
+
+  for (auto& node : nodes) node.renderer = createRenderer();
+
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - begin;
+  LOG_INFO("PointOctree - {} points in {} nodes, built in {:.2f} s",
+           point_count, nodes.size(), elapsed.count());
+  built.store(true, std::memory_order_release);
+}
+
+void PointOctree::buildNode(uint32_t index,
+                            std::vector<uint32_t>& order,
+                            std::vector<uint32_t>& scratch,
+                            size_t begin,
+                            size_t end,
+                            int depth) {
+  if (stop) return;
+
+  Node& node = nodes[index];  // deque, stays valid while children are added
+  node.first = begin;
+  node.count = end - begin;
+  if (node.count <= NODE_CAPACITY || depth == MAX_DEPTH) return;
+  node.count = NODE_CAPACITY;
+
+  // the rest by octant, stable so each child stays in random order.
+  const Eigen::Vector3f center = node.box.center();
+  auto octant = [&](uint32_t point) {
+    const Eigen::Vector3f& p = positions[point];
+    return (p.x() >= center.x()) | (p.y() >= center.y()) << 1 |
+           (p.z() >= center.z()) << 2;
+  };
+
+  const size_t rest = begin + NODE_CAPACITY;
+  size_t offsets[9] = {};
+  for (size_t i = rest; i < end; i++) offsets[octant(order[i]) + 1]++;
+  for (int o = 0; o < 8; o++) offsets[o + 1] += offsets[o];
+
+  size_t fill[8];
+  std::copy(offsets, offsets + 8, fill);
+  for (size_t i = rest; i < end; i++)
+    scratch[rest + fill[octant(order[i])]++] = order[i];
+  std::copy(scratch.begin() + rest, scratch.begin() + end,
+            order.begin() + rest);
+
+  for (int o = 0; o < 8; o++) {
+    if (offsets[o + 1] == offsets[o]) continue;
+
+    const uint32_t child = static_cast<uint32_t>(nodes.size());
+    nodes.emplace_back();
+    nodes[child].box = octantBox(node.box, o);
+    node.children[o] = static_cast<int32_t>(child);
+    buildNode(child, order, scratch, rest + offsets[o], rest + offsets[o + 1],
+              depth + 1);
+  }
+}
+
+void PointOctree::load(Node& node) {
+  // packed (and quantized) here, draw() only uploads.
+  const AttributeView color_view =
+      has_color ? AttributeView(colors[node.first].data(), node.count,
+                                sizeof(Eigen::Vector3f))
+                : AttributeView();
+  const AttributeView scalar_view =
+      has_scalar
+          ? AttributeView(&scalars[node.first], node.count, sizeof(float))
+          : AttributeView();
+
+  node.renderer->setData(AttributeView(positions[node.first].data(),
+                                       node.count, sizeof(Eigen::Vector3f)),
+                         color_view, scalar_view);
+}
+
+std::unique_ptr<GeneralRenderer> PointOctree::createRenderer() const {
+  return GeneralRenderer::create(GeneralRenderer::BufferType::STATIC,
+                                 GeneralRenderer::RenderTarget::POINT,
+                                 has_color, has_scalar, format);
+}
+
+// gl thread ==========================================================
+void PointOctree::draw(const View& view,
+                       const Eigen::Matrix4f& model_matrix,
+                       const GeneralRenderer::ChunkCallback& before_chunk) {
+  if (built.load(std::memory_order_acquire) == false) return;
+  node_count = nodes.size();
+  frame++;
+
+  select(view, model_matrix);
+
+  // a node not uploaded yet leaves a coarser sample, its parents, on screen.
+  const size_t upload_cap = max_upload_points;
+  size_t uploaded = 0;
+  drawn_points = 0;
+  drawn_nodes = 0;
+  for (const uint32_t index : selected) {
+    Node& node = nodes[index];
+    if (node.state.load(std::memory_order_acquire) != LOADED) continue;
+
+    if (node.resident == false) {
+      if (uploaded + node.count > upload_cap && uploaded != 0) {
+        FrameRequest::request();  // rest next frame
+        continue;
+      }
+      uploaded += node.count;
+      node.resident = true;
+      resident_nodes.push_back(index);
+      resident_points += node.count;
+    }
+
+    node.last_drawn = frame;
+    node.renderer->draw(before_chunk);
+    drawn_points += node.count;
+    drawn_nodes++;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(request_mtx);
+    requests.assign(missing.begin(), missing.end());
+    pending_nodes.insert(pending_nodes.end(), loaded.begin(), loaded.end());
+    loaded.clear();
+  }
+  if (missing.empty() == false) request_cv.notify_one();
+
+  evict();
+  expire();
+}
+
+void PointOctree::select(const View& view,
+                         const Eigen::Matrix4f& model_matrix) {
+  selected.clear();
+  missing.clear();
+
+  const Eigen::Matrix4f mvp = view.vp_matrix * model_matrix;
+  const float scale =
+      model_matrix.block<3, 3>(0, 0).colwise().norm().maxCoeff();
+
+  // radius on screen in pixels, unbounded with the camera inside the node.
+  auto priority = [&](const Node& node) {
+    const float radius = 0.5f * node.box.sizes().norm() * scale;
+    const float w = mvp.row(3).dot(node.box.center().homogeneous());
+    if (w <= radius) return std::numeric_limits<float>::max();
+
+    const float pixel = view.pixelSize(w);
+    return pixel > 0.0f ? radius / pixel : 0.0f;
+  };
+
+  std::priority_queue<std::pair<float, uint32_t>> queue;
+  auto push = [&](uint32_t index) {
+    const Node& node = nodes[index];
+    if (view.intersects(node.box, model_matrix))
+      queue.emplace(priority(node), index);
+  };
+
+  const size_t budget = point_budget;
+  size_t points = 0;
+  push(0);
+  while (queue.empty() == false) {
+    const uint32_t index = queue.top().second;
+    queue.pop();
+
+    Node& node = nodes[index];
+    if (points + node.count > budget) break;
+    points += node.count;
+
+    selected.push_back(index);
+    node.last_selected = frame;
+    if (node.state.load(std::memory_order_acquire) == UNLOADED)
+      missing.push_back(index);
+
+    for (const int32_t child : node.children)
+      if (child >= 0) push(static_cast<uint32_t>(child));
+  }
+}
+
+void PointOctree::evict() {
+  const size_t limit = max_resident_points;
+  if (resident_points <= limit) return;
+
+  // least recently drawn first, never what this frame drew.
+  std::sort(resident_nodes.begin(), resident_nodes.end(),
+            [this](uint32_t a, uint32_t b) {
+              return nodes[a].last_drawn < nodes[b].last_drawn;
+            });
+
+  size_t freed = 0;
+  while (freed < resident_nodes.size() && resident_points > limit) {
+    Node& node = nodes[resident_nodes[freed]];
+    if (node.last_drawn == frame) break;
+
+    node.renderer->glFree();
+    node.resident = false;
+    node.state.store(UNLOADED, std::memory_order_release);
+    resident_points -= node.count;
+    freed++;
+  }
+  resident_nodes.erase(resident_nodes.begin(), resident_nodes.begin() + freed);
+}
+
+void PointOctree::expire() {
+  // a node selected when requested may be off screen by the time it loads.
+  size_t kept = 0;
+  for (const uint32_t index : pending_nodes) {
+    Node& node = nodes[index];
+    // uploaded since, or freed after
+    if (node.resident || node.state.load(std::memory_order_acquire) != LOADED)
+      continue;
+
+    if (node.last_selected + EXPIRE_FRAMES < frame) {
+      // not resident, so nothing on the gpu; a new renderer drops the payload.
+      node.renderer = createRenderer();
+      node.state.store(UNLOADED, std::memory_order_release);
+      continue;
+    }
+    pending_nodes[kept++] = index;
+  }
+  pending_nodes.resize(kept);
+}
+
+void PointOctree::glFree() {
+  for (const uint32_t index : resident_nodes) {
+    Node& node = nodes[index];
+    node.renderer->glFree();
+    node.resident = false;
+    node.state.store(UNLOADED, std::memory_order_release);
+  }
+  resident_nodes.clear();
+  resident_points = 0;
+}
+
+Eigen::AlignedBox3f PointOctree::glBounds() const {
+  if (built.load(std::memory_order_acquire) == false)
+    return Eigen::AlignedBox3f();
+  return nodes[0].box;
+}
+
+}  // namespace gl
+}  // namespace seg
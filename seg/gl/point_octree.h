@@ -0,0 +1,145 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "seg/attribute_view.h"
+#include "seg/gl/general_renderer.h"
+#include "seg/gl/view.h"
+#include "seg/types.h"  // seg::VertexFormat
+
+namespace seg {
+namespace gl {
+/**
+ * Point cloud in an octree of nested random subsamples. (as in Potree)
+ * Every node keeps up to NODE_CAPACITY points of its cell, the rest go to
+ * its children, so a node plus its ancestors is a denser sample of the cell.
+ *
+ * Each frame the nodes largest on screen are drawn, up to a point budget.
+ * Missing nodes are packed on a loader thread, which also builds the tree,
+ * and uploaded by draw() under a per frame cap. Least recently drawn nodes
+ * leave gpu memory beyond max_resident_points; nodes loaded but unselected
+ * for EXPIRE_FRAMES drop their packed points.
+ */
+class PointOctree {
+ public:
+  static const size_t NODE_CAPACITY = 20000;
+  static const int MAX_DEPTH = 20;
+  static const uint64_t EXPIRE_FRAMES = 120;  // draw() calls
+
+  // copies the points. empty / mismatched colors and scalars are dropped.
+  PointOctree(const AttributeView& vertices,
+              const AttributeView& colors,
+              const AttributeView& scalars,
+              VertexFormat format);
+  ~PointOctree();
+  PointOctree(const PointOctree&) = delete;
+  PointOctree& operator=(const PointOctree&) = delete;
+
+  // any thread
+  std::atomic<size_t> point_budget{5000000};         // drawn per frame
+  std::atomic<size_t> max_resident_points{20000000};  // kept on the gpu
+  std::atomic<size_t> max_upload_points{2000000};     // uploaded per frame
+
+  const bool& hasColor() const { return has_color; }
+  const bool& hasScalar() const { return has_scalar; }
+  const size_t& pointCount() const { return point_count; }
+
+  // gl thread side =================================================
+  /**
+   * @brief Selects, streams and draws nodes for view. Nothing is drawn until
+   *        the loader thread has built the tree.
+   * @param before_chunk - see GeneralRenderer::draw()
+   */
+  void draw(const View& view,
+            const Eigen::Matrix4f& model_matrix,
+            const GeneralRenderer::ChunkCallback& before_chunk);
+  void glFree();
+
+  // cube around every point, empty until built.
+  Eigen::AlignedBox3f glBounds() const;
+
+  // as of the last draw()
+  const size_t& nodeCount() const { return node_count; }
+  const size_t& drawnPoints() const { return drawn_points; }
+  const size_t& drawnNodes() const { return drawn_nodes; }
+  const size_t& residentPoints() const { return resident_points; }
+
+ private:
+  enum State : int { UNLOADED, LOADING, LOADED };
+
+  struct Node {
+    Eigen::AlignedBox3f box;  // octree cell
+    size_t first = 0;         // points of the node, in the sorted arrays
+    size_t count = 0;
+    int32_t children[8] = {-1, -1, -1, -1, -1, -1, -1, -1};
+
+    std::unique_ptr<GeneralRenderer> renderer;
+    std::atomic<int> state{UNLOADED};  // loader -> gl thread
+
+    // gl thread side
+    bool resident = false;
+    uint64_t last_drawn = 0;
+    uint64_t last_selected = 0;
+  };
+
+  // loader thread ==================================================
+  void loaderLoop();
+  void build();
+  void buildNode(uint32_t index,
+                 std::vector<uint32_t>& order,
+                 std::vector<uint32_t>& scratch,
+                 size_t begin,
+                 size_t end,
+                 int depth);
+  void load(Node& node);
+  std::unique_ptr<GeneralRenderer> createRenderer() const;
+
+  // gl thread ======================================================
+  // nodes by screen size under the budget, parents before children.
+  void select(const View& view, const Eigen::Matrix4f& model_matrix);
+  void evict();
+  void expire();
+
+  const VertexFormat format;
+  size_t point_count = 0;
+  bool has_color = false;
+  bool has_scalar = false;
+
+  // sorted by node once built, read by the loader only afterwards.
+  std::vector<Eigen::Vector3f> positions;
+  std::vector<Eigen::Vector3f> colors;
+  std::vector<float> scalars;
+
+  std::deque<Node> nodes;  // [0] is the root
+  std::atomic<bool> built{false};
+
+  std::mutex request_mtx;
+  std::condition_variable request_cv;
+  std::deque<uint32_t> requests;  // by priority, replaced every frame
+  std::vector<uint32_t> loaded;   // since the last frame took them
+  std::atomic<bool> stop{false};
+  std::thread loader;
+
+  // gl thread side
+  uint64_t frame = 0;
+  std::vector<uint32_t> selected;
+  std::vector<uint32_t> missing;
+  std::vector<uint32_t> resident_nodes;
+  std::vector<uint32_t> pending_nodes;  // loaded, not uploaded yet
+  size_t node_count = 0;
+  size_t drawn_points = 0;
+  size_t drawn_nodes = 0;
+  size_t resident_points = 0;
+
+};  // class PointOctree
+}  // namespace gl
+}  // namespace seg
@@ -0,0 +1,241 @@
+#include "seg/gl/program_cache.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "seg/core/config.h"
+#include "seg/internal/logger.h"
+
+static std::once_flag instance_flag;
+static std::unique_ptr<seg::gl::ProgramCache> program_cache;
+
+namespace {
+// layout of a cache file, followed by the binary
+struct FileHeader {
+  char magic[4];
+  uint32_t version;  // of this layout
+  uint64_t key;
+  uint32_t format;  // binary format, as reported by the driver
+  uint32_t length;
+};
+const char FILE_MAGIC[4] = {'S', 'E', 'G', 'P'};
+const uint32_t FILE_VERSION = 1;
+
+// FNV-1a
+uint64_t hashString(uint64_t hash, const std::string& str) {
+  for (const char c : str) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ull;
+  }
+  // separator, so "ab" + "c" and "a" + "bc" differ
+  hash ^= 0xff;
+  hash *= 1099511628211ull;
+  return hash;
+}
+
+std::string glString(GLenum name) {
+  const GLubyte* str = glGetString(name);
+  return str ? reinterpret_cast<const char*>(str) : "";
+}
+
+// a name no other process or call picks, so writers never share a tmp file.
+std::string uniqueSuffix() {
+  static std::atomic<uint64_t> counter{0};
+  static const uint64_t process_token =
+      (static_cast<uint64_t>(std::random_device()()) << 32) ^
+      static_cast<uint64_t>(
+          std::chrono::steady_clock::now().time_since_epoch().count());
+
+  char suffix[48];
+  std::snprintf(suffix, sizeof(suffix), ".%016llx.%llu.tmp",
+                static_cast<unsigned long long>(process_token),
+                static_cast<unsigned long long>(counter.fetch_add(1)));
+  return suffix;
+}
+
+// $XDG_CACHE_HOME/seg/shaders, ~/.cache/seg/shaders
+std::string defaultDirectory() {
+  const char* xdg_cache = std::getenv("XDG_CACHE_HOME");
+  if (xdg_cache && xdg_cache[0] != '\0')
+    return std::string(xdg_cache) + "/seg/shaders";
+
+  const char* home = std::getenv("HOME");
+  if (home && home[0] != '\0')
+    return std::string(home) + "/.cache/seg/shaders";
+
+  return "";
+}
+}  // namespace
+
+namespace seg {
+namespace gl {
+ProgramCache& ProgramCache::getInstance() {
+  std::call_once(instance_flag,
+                 [] { program_cache.reset(new ProgramCache()); });
+
+  return *(program_cache.get());
+}
+
+bool ProgramCache::enabled() {
+  if (!initialized) init();
+  return usable;
+}
+
+void ProgramCache::init() {
+  initialized = true;
+  if (getConfig().use_shader_cache == false) return;
+
+  GLint formats = 0;
+  if (GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary)
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+  if (formats <= 0) {
+    LOG_DEBUG("program cache - driver has no program binary formats.");
+    return;
+  }
+
+  directory = getConfig().shader_cache_dir;
+  if (directory.empty()) directory = defaultDirectory();
+  if (directory.empty()) return;
+
+  std::error_code error;
+  std::filesystem::create_directories(directory, error);
+  if (error) {
+    LOG_WARN("program cache - can't create [{}], disabled. {}", directory,
+             error.message());
+    return;
+  }
+
+  driver = glString(GL_VENDOR) + "\n" + glString(GL_RENDERER) + "\n" +
+           glString(GL_VERSION);
+  usable = true;
+  LOG_DEBUG("program cache - at [{}].", directory);
+}
+
+GLuint ProgramCache::load(const std::string& vert, const std::string& frag) {
+  if (!enabled()) {
+    miss_count++;
+    return 0;
+  }
+
+  const uint64_t program_key = key(vert, frag);
+  const std::string file_path = path(program_key);
+  std::ifstream file(file_path, std::ios::binary);
+  if (!file) {
+    miss_count++;
+    return 0;
+  }
+
+  FileHeader header;
+  std::vector<char> binary;
+  file.read(reinterpret_cast<char*>(&header), sizeof(header));
+  bool complete = file && std::memcmp(header.magic, FILE_MAGIC, 4) == 0 &&
+                  header.version == FILE_VERSION &&
+                  header.key == program_key && header.length > 0;
+  if (complete) {
+    binary.resize(header.length);
+    file.read(binary.data(), header.length);
+    complete = static_cast<size_t>(file.gcount()) == binary.size();
+  }
+  file.close();
+
+  GLuint program = 0;
+  GLint linked = GL_FALSE;
+  if (complete) {
+    program = glCreateProgram();
+    glProgramBinary(program, header.format, binary.data(),
+                    static_cast<GLsizei>(binary.size()));
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+  }
+
+  // stale, truncated, or the driver changed under the same strings
+  if (linked == GL_FALSE) {
+    if (program != 0) glDeleteProgram(program);
+    std::error_code error;
+    std::filesystem::remove(file_path, error);
+    LOG_DEBUG("program cache - dropped unusable [{}].", file_path);
+    miss_count++;
+    return 0;
+  }
+
+  hit_count++;
+  return program;
+}
+
+void ProgramCache::prepare(GLuint program) {
+  if (!enabled()) return;
+  glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+void ProgramCache::store(GLuint program,
+                         const std::string& vert,
+                         const std::string& frag) {
+  if (!enabled()) return;
+
+  GLint length = 0;
+  glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0) return;
+
+  std::vector<char> binary(length);
+  GLsizei written = 0;
+  GLenum format = 0;
+  glGetProgramBinary(program, length, &written, &format, binary.data());
+  if (written <= 0) return;
+
+  FileHeader header;
+  std::memcpy(header.magic, FILE_MAGIC, 4);
+  header.version = FILE_VERSION;
+  header.key = key(vert, frag);
+  header.format = format;
+  header.length = static_cast<uint32_t>(written);
+
+  // written aside and renamed, so another process never reads half a file.
+  // two processes storing the same program each rename a whole file.
+  const std::string file_path = path(header.key);
+  const std::string tmp_path = file_path + uniqueSuffix();
+  std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(binary.data(), written);
+  file.close();
+  if (!file) {  // e.g. a full disk, no partial file left behind
+    std::remove(tmp_path.c_str());
+    LOG_WARN("program cache - can't write [{}].", tmp_path);
+    return;
+  }
+  if (std::rename(tmp_path.c_str(), file_path.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+    LOG_WARN("program cache - can't write [{}].", file_path);
+  }
+}
+
+uint64_t ProgramCache::key(const std::string& vert,
+                           const std::string& frag) const {
+  uint64_t hash = 14695981039346656037ull;
+  hash = hashString(hash, driver);
+  hash = hashString(hash, vert);
+  hash = hashString(hash, frag);
+  return hash;
+}
+
+std::string ProgramCache::path(uint64_t key) const {
+  char name[32];
+  std::snprintf(name, sizeof(name), "%016llx.bin",
+                static_cast<unsigned long long>(key));
+  return directory + "/" + name;
+}
+
+}  // namespace gl
+}  // namespace seg
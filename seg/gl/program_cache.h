@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <GL/glew.h>
+
+namespace seg {
+namespace gl {
+/**
+ * Linked programs on disk (glGetProgramBinary), so a warm start skips
+ * compiling. Entries are keyed by the sources and the driver (vendor,
+ * renderer, version); a missing, stale or rejected binary is a miss, and
+ * the caller compiles as before.
+ * Directory and on / off from Config. gl thread only.
+ */
+class ProgramCache {
+ public:
+  static ProgramCache& getInstance();
+
+  // false without GL 4.1 / ARB_get_program_binary or a usable directory.
+  bool enabled();
+
+  /**
+   * @return a linked program of vert / frag, or 0 if there is no usable
+   *         binary. A binary the driver rejects is removed.
+   */
+  GLuint load(const std::string& vert, const std::string& frag);
+  // before glLinkProgram of a program to store()
+  void prepare(GLuint program);
+  // failing to write only logs, the program is still good.
+  void store(GLuint program, const std::string& vert, const std::string& frag);
+
+  // since start, programs loaded from the cache / left to compile
+  uint64_t hits() const { return hit_count; }
+  uint64_t misses() const { return miss_count; }
+
+ private:
+  ProgramCache() {}
+
+  void init();
+  uint64_t key(const std::string& vert, const std::string& frag) const;
+  std::string path(uint64_t key) const;
+
+  bool initialized = false;
+  bool usable = false;
+  std::string directory;
+  std::string driver;  // vendor, renderer, version
+
+  uint64_t hit_count = 0;
+  uint64_t miss_count = 0;
+
+};  // class ProgramCache
+}  // namespace gl
+}  // namespace seg
@@ -0,0 +1,100 @@
+#include "seg/gl/render_state.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include <GL/glew.h>
+
+static std::once_flag instance_flag;
+static std::unique_ptr<seg::gl::RenderState> render_state;
+
+namespace seg {
+namespace gl {
+RenderState& RenderState::getInstance() {
+  std::call_once(instance_flag,
+                 [] { render_state.reset(new RenderState()); });
+
+  return *(render_state.get());
+}
+
+void RenderState::beginFrame() {
+  invalidate();
+  draw_calls = 0;
+  state_changes = 0;
+}
+
+void RenderState::invalidate() {
+  program.known = false;
+  depth_test.known = false;
+  depth_func.known = false;
+  blend.known = false;
+  line_width.known = false;
+  point_size.known = false;
+}
+
+void RenderState::useProgram(GLuint _program) {
+  if (program.update(_program) == false) return;
+  glUseProgram(_program);
+  state_changes++;
+}
+
+void RenderState::setDepthTest(bool enable, GLenum func) {
+  if (depth_test.update(enable)) {
+    if (enable)
+      glEnable(GL_DEPTH_TEST);
+    else
+      glDisable(GL_DEPTH_TEST);
+    state_changes++;
+  }
+
+  if (enable && depth_func.update(func)) {
+    glDepthFunc(func);
+    state_changes++;
+  }
+}
+
+void RenderState::setBlend(bool enable) {
+  if (blend.update(enable) == false) return;
+
+  if (enable) {
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  } else
+    glDisable(GL_BLEND);
+  state_changes++;
+}
+
+void RenderState::setLineWidth(float width) {
+  if (line_width.update(width) == false) return;
+  glLineWidth(width);
+  state_changes++;
+}
+
+void RenderState::setPointSize(float size) {
+  if (point_size.update(size) == false) return;
+  glPointSize(size);
+  state_changes++;
+}
+
+uint64_t makeSortKey(bool blend,
+                     uint32_t variant,
+                     GLenum primitive,
+                     float size,
+                     const void* geometry) {
+  // 1 | 6 | 3 | 20 | 34 bits, size in 1/16 px
+  const float max_size = static_cast<float>((1 << 20) - 1);
+  const uint64_t size_bits = static_cast<uint64_t>(
+      std::min(std::max(size, 0.0f) * 16.0f, max_size));
+  const uint64_t geometry_bits =
+      (reinterpret_cast<uintptr_t>(geometry) >> 4) & ((1ull << 34) - 1);
+
+  return static_cast<uint64_t>(blend) << 63 |
+         static_cast<uint64_t>(variant & 0x3f) << 57 |
+         static_cast<uint64_t>(primitive & 0x7) << 54 | size_bits << 34 |
+         geometry_bits;
+}
+
+}  // namespace gl
+}  // namespace seg
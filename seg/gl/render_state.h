@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+
+#include <GL/glew.h>
+
+namespace seg {
+namespace gl {
+/**
+ * Shadow of the fixed function state objects set while drawing, so setting
+ * a value already in place costs no gl call. Counts draw calls and the
+ * state changes that did reach gl, per frame.
+ * gl thread only. Code changing the same state around it (imgui) must be
+ * followed by invalidate().
+ */
+class RenderState {
+ public:
+  static RenderState& getInstance();
+
+  // forgets the shadowed state and resets the counters.
+  void beginFrame();
+  void invalidate();
+
+  void useProgram(GLuint program);
+  void setDepthTest(bool enable, GLenum func = GL_LESS);
+  // blending is always SRC_ALPHA, ONE_MINUS_SRC_ALPHA
+  void setBlend(bool enable);
+  void setLineWidth(float width);
+  void setPointSize(float size);
+
+  void countDrawCall() { draw_calls++; }
+
+  // this frame so far
+  uint64_t drawCalls() const { return draw_calls; }
+  uint64_t stateChanges() const { return state_changes; }
+
+ private:
+  RenderState() {}
+
+  // known - false: value unknown, the next set goes through.
+  template <typename T>
+  struct Shadow {
+    bool known = false;
+    T value{};
+
+    bool update(const T& _value) {
+      if (known && value == _value) return false;
+      known = true;
+      value = _value;
+      return true;
+    }
+  };
+
+  Shadow<GLuint> program;
+  Shadow<bool> depth_test;
+  Shadow<GLenum> depth_func;
+  Shadow<bool> blend;
+  Shadow<float> line_width;
+  Shadow<float> point_size;
+
+  uint64_t draw_calls = 0;
+  uint64_t state_changes = 0;
+
+};  // class RenderState
+
+/**
+ * Draw order key, so that draws sharing state end up next to each other.
+ * Most significant first: blended after opaque, program (ShaderVariant::key),
+ * primitive type, line width / point size, then geometry.
+ */
+uint64_t makeSortKey(bool blend,
+                     uint32_t variant,
+                     GLenum primitive,
+                     float size,
+                     const void* geometry);
+}  // namespace gl
+}  // namespace seg
@@ -5,6 +5,7 @@
 #include <GLFW/glfw3.h>
 
 #include "seg/core/config.h"
+#include "seg/core/frame_request.h"
 #include "seg/gl/grid_renderer.h"
 #include "seg/internal/logger.h"
 
@@ -14,6 +15,7 @@ void Scene::init(GLFWwindow* window) {
   // shaders
   general_shader.init(ShaderType::GENERAL);
   grid_shader.init(ShaderType::GRID);
+  frame_uniforms.init();
 
   // camera
   int width, height;
@@ -34,6 +36,7 @@ void Scene::init(GLFWwindow* window) {
         glfwGetWindowSize(w, &win_width, &win_height);
         scene->camera.onScreenResize(win_width, win_height);
         scene->onScreenResize(fb_width, fb_height);
+        FrameRequest::request();
       });
 
   // base object - grid
@@ -65,13 +68,19 @@ void Scene::updateVpMatrix() {
   Eigen::Matrix4f vp_matrix =
       camera.getProjectionMatrix() * camera.getViewMatrix();
 
-  general_shader.bind();
-  general_shader.setUniform("vp_matrix", vp_matrix);
+  // camera moved -> another frame, for view dependent lod to catch up.
+  if (vp_matrix != view.vp_matrix) FrameRequest::request();
 
-  Eigen::Matrix4f inv_vp_matrix = vp_matrix.inverse();
-  grid_shader.bind();
-  grid_shader.setUniform("vp_matrix", vp_matrix);
-  grid_shader.setUniform("inv_vp_matrix", inv_vp_matrix);
+  view.vp_matrix = vp_matrix;
+  view.projection_matrix = camera.getProjectionMatrix();
+  view.viewport = camera.getWindowSize();
+  view.eye = camera.getViewMatrix().inverse().block<3, 1>(0, 3);
+
+  // one upload for every program
+  FrameUniforms frame;
+  frame.vp_matrix = vp_matrix;
+  frame.inv_vp_matrix = vp_matrix.inverse();
+  frame_uniforms.update(frame);
 }
 
 }  // namespace gl
@@ -5,6 +5,8 @@
 
 #include "seg/gl/camera.h"
 #include "seg/gl/shader.h"
+#include "seg/gl/uniform_buffer.h"
+#include "seg/gl/view.h"
 #include "seg/object/gl_object.h"
 
 class GLFWwindow;
@@ -23,6 +25,8 @@ class Scene {
   Camera camera;
   Shader general_shader;
   Shader grid_shader;
+  FrameUniformBuffer frame_uniforms;
+  View view;  // of the current frame
 
  private:
   void clear();
@@ -7,6 +7,10 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 
+#include "seg/gl/program_cache.h"
+#include "seg/gl/render_state.h"
+#include "seg/gl/uniform_buffer.h"
+#include "seg/gl/vertex_layout.h"
 #include "seg/internal/logger.h"
 
 namespace {
@@ -28,6 +32,24 @@ struct ShaderSource {
   const std::string& frag;
 };
 
+// by seg::gl::Uniform
+const char* uniform_names[] = {
+    "model_matrix",
+    "uniform_color",
+    "pose_table",
+    "visualize_hue_from",
+    "visualize_hue_to",
+    "visualize_saturation",
+    "visualize_value",
+    "visualize_z_min",
+    "visualize_z_max",
+    "grid_color",
+    "grid_fade_distance",
+};
+static_assert(sizeof(uniform_names) / sizeof(uniform_names[0]) ==
+                  static_cast<size_t>(seg::gl::Uniform::COUNT),
+              "a name for every seg::gl::Uniform");
+
 ShaderSource getSource(seg::gl::ShaderType type) {
   switch (type) {
     case seg::gl::ShaderType::GRID:
@@ -37,59 +59,104 @@ ShaderSource getSource(seg::gl::ShaderType type) {
       return {general_vert, general_frag};
   }
 }
+
+// sources leave out #version, which has to come before the defines.
+std::string defines(const seg::gl::ShaderVariant& variant) {
+  std::string out = "#define COLOR_MODE " +
+                    std::to_string(static_cast<int>(variant.color_mode)) +
+                    "\n";
+  if (variant.features & seg::gl::SHADER_INSTANCED)
+    out += "#define INSTANCED\n";
+  if (variant.features & seg::gl::SHADER_INSTANCE_COLOR)
+    out += "#define INSTANCE_COLOR\n";
+  if (variant.features & seg::gl::SHADER_POSE_TABLE)
+    out += "#define POSE_TABLE\n";
+  return out;
+}
+
+GLuint compileStage(GLenum stage, const std::string& src, const char* name) {
+  GLuint shader = glCreateShader(stage);
+  const char* src_cstr = src.c_str();
+  glShaderSource(shader, 1, &src_cstr, nullptr);
+  glCompileShader(shader);
+
+  GLint result = GL_FALSE;
+  glGetShaderiv(shader, GL_COMPILE_STATUS, &result);
+  if (result == GL_FALSE) {
+    int err_len;
+    glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &err_len);
+    std::vector<char> err(err_len + 1);
+    glGetShaderInfoLog(shader, err_len, nullptr, err.data());
+    glDeleteShader(shader);
+    throw std::runtime_error("Error While Compiling " + std::string(name) +
+                             " Shader! " + std::string(&err[0]));
+  }
+  return shader;
+}
 }  // namespace
 
 namespace seg {
 
 namespace gl {
+const char* uniformName(Uniform uniform) {
+  return uniform_names[static_cast<size_t>(uniform)];
+}
+
 Shader::~Shader() {
-  if (program != 0) glDeleteProgram(program);
+  for (auto& program : programs) glDeleteProgram(program.second.id);
 }
 
 void Shader::init(ShaderType _type) {
   type = _type;
-  auto src = getSource(type);
-  attatchShader(src.vert, src.frag);
-  setDefaultSettings();
+  if (type == ShaderType::GRID) {
+    variant(ShaderVariant());
+    return;
+  }
+
+  // used by almost every object, compiled up front.
+  for (const ColorMode mode :
+       {ColorMode::UNIFORM, ColorMode::RGB, ColorMode::RGBA, ColorMode::SCALAR,
+        ColorMode::ZAXIS})
+    variant(ShaderVariant(mode));
+  LOG_DEBUG("shader - {} variants compiled.", programs.size());
 }
 
-void Shader::attatchShader(const std::string& vert_src,
-                           const std::string& frag_src) {
-  // create shader & gl program
-  GLuint vert_shader = glCreateShader(GL_VERTEX_SHADER);
-  GLuint frag_shader = glCreateShader(GL_FRAGMENT_SHADER);
-  program = glCreateProgram();
+Shader::Program& Shader::variant(const ShaderVariant& variant) {
+  // grid has a single program
+  const uint32_t key = (type == ShaderType::GRID) ? 0 : variant.key();
+  auto iter = programs.find(key);
+  if (iter != programs.end()) return iter->second;
 
-  GLint result = GL_FALSE;
-  int err_len;
+  Program& program = programs[key];
+  program.id = compile(defines(variant));
+  resolveUniforms(program);
+  setDefaultSettings(program);
+  return program;
+}
 
-  // compile vertex shader
-  const char* vshader_cstr = vert_src.c_str();
-  glShaderSource(vert_shader, 1, &vshader_cstr, nullptr);
-  glCompileShader(vert_shader);
-  glGetShaderiv(vert_shader, GL_COMPILE_STATUS, &result);
-  if (result == GL_FALSE) {
-    glGetShaderiv(vert_shader, GL_INFO_LOG_LENGTH, &err_len);
-    std::vector<char> err(err_len);
-    glGetShaderInfoLog(vert_shader, err_len, nullptr, err.data());
-    throw std::runtime_error("Error While Compiling Vertex Shader! " +
-                             std::string(&err[0]));
-  }
+GLuint Shader::compile(const std::string& defines) {
+  const auto src = getSource(type);
+  const std::string version = "#version 330\n";
+  const std::string vert = version + defines + src.vert;
+  const std::string frag = version + defines + src.frag;
 
-  // compile fragment shader
-  const char* fshader_cstr = frag_src.c_str();
-  glShaderSource(frag_shader, 1, &fshader_cstr, nullptr);
-  glCompileShader(frag_shader);
-  glGetShaderiv(frag_shader, GL_COMPILE_STATUS, &result);
-  if (result == GL_FALSE) {
-    glGetShaderiv(frag_shader, GL_INFO_LOG_LENGTH, &err_len);
-    std::vector<char> err(err_len);
-    glGetShaderInfoLog(frag_shader, err_len, nullptr, err.data());
-    throw std::runtime_error("Error While Compiling Fragment Shader! " +
-                             std::string(&err[0]));
+  // linked on an earlier run with the same sources and driver
+  ProgramCache& cache = ProgramCache::getInstance();
+  const GLuint cached = cache.load(vert, frag);
+  if (cached != 0) return cached;
+
+  GLuint vert_shader = compileStage(GL_VERTEX_SHADER, vert, "Vertex");
+  GLuint frag_shader;
+  try {
+    frag_shader = compileStage(GL_FRAGMENT_SHADER, frag, "Fragment");
+  } catch (...) {
+    glDeleteShader(vert_shader);
+    throw;
   }
 
   // attatch & delete shaders
+  GLuint program = glCreateProgram();
+  cache.prepare(program);
   glAttachShader(program, vert_shader);
   glAttachShader(program, frag_shader);
   glLinkProgram(program);
@@ -97,66 +164,102 @@ void Shader::attatchShader(const std::string& vert_src,
   glDeleteShader(frag_shader);
 
   // error handle
+  GLint result = GL_FALSE;
   glGetProgramiv(program, GL_LINK_STATUS, &result);
   if (result == GL_FALSE) {
+    int err_len;
     glGetProgramiv(program, GL_INFO_LOG_LENGTH, &err_len);
-    std::vector<char> err(err_len);
+    std::vector<char> err(err_len + 1);
     glGetProgramInfoLog(program, err_len, nullptr, err.data());
+    glDeleteProgram(program);
     throw std::runtime_error("Error While Attatching Shader! " +
                              std::string(&err[0]));
   }
+
+  cache.store(program, vert, frag);
+  return program;
+}
+
+void Shader::resolveUniforms(Program& program) {
+  for (size_t i = 0; i < program.uniform_ids.size(); i++)
+    program.uniform_ids[i] = glGetUniformLocation(program.id, uniform_names[i]);
+
+  const GLuint frame_block = glGetUniformBlockIndex(program.id, "Frame");
+  if (frame_block != GL_INVALID_INDEX)
+    glUniformBlockBinding(program.id, frame_block, UNIFORM_BLOCK_FRAME);
 }
 
-void Shader::setDefaultSettings() {
-  bind();
+void Shader::setDefaultSettings(Program& program) {
+  Program* const previous = current;
+  RenderState::getInstance().useProgram(program.id);
+  current = &program;
+
   switch (type) {
     case ShaderType::GENERAL:
-      setUniform("visualize_hue_from", 1.0f);
-      setUniform("visualize_hue_to", 0.3f);
-      setUniform("visualize_saturation", 0.6f);
-      setUniform("visualize_value", 0.7f);
-      setUniform("visualize_z_min", 1.0f);
-      setUniform("visualize_z_max", 0.0f);
+      // generic values read by the instance attributes while no instance
+      // buffer is attached (identity). context state, not per program.
+      glVertexAttrib4f(ATTRIB_INSTANCE_ROTATION, 0, 0, 0, 1);
+      glVertexAttrib4f(ATTRIB_INSTANCE_TRANSLATION, 0, 0, 0, 1);
+      glVertexAttrib4f(ATTRIB_INSTANCE_COLOR, 0, 0, 0, 1);
+
+      setUniform(Uniform::POSE_TABLE,
+                 static_cast<int>(TEXTURE_UNIT_POSE_TABLE));
+
+      setUniform(Uniform::VISUALIZE_HUE_FROM, 1.0f);
+      setUniform(Uniform::VISUALIZE_HUE_TO, 0.3f);
+      setUniform(Uniform::VISUALIZE_SATURATION, 0.6f);
+      setUniform(Uniform::VISUALIZE_VALUE, 0.7f);
+      setUniform(Uniform::VISUALIZE_Z_MIN, 1.0f);
+      setUniform(Uniform::VISUALIZE_Z_MAX, 0.0f);
       break;
     case ShaderType::GRID:
-      setUniform("grid_color", Eigen::Vector4f(0.5f, 0.5f, 0.5f, 0.5f));
-      setUniform("grid_fade_distance", 200.0f);
+      setUniform(Uniform::GRID_COLOR,
+                 Eigen::Vector4f(0.5f, 0.5f, 0.5f, 0.5f));
+      setUniform(Uniform::GRID_FADE_DISTANCE, 200.0f);
       break;
   }
-  unbind();
+
+  // compiled mid frame by bind(), which binds it right after.
+  current = previous;
+  RenderState::getInstance().useProgram(previous ? previous->id : 0);
 }
 
-void Shader::bind() { glUseProgram(program); }
+void Shader::bind() { bind(ShaderVariant()); }
+
+void Shader::bind(const ShaderVariant& _variant) {
+  current = &variant(_variant);
+  RenderState::getInstance().useProgram(current->id);
+}
 
-void Shader::unbind() { glUseProgram(0); }
+void Shader::unbind() { RenderState::getInstance().useProgram(0); }
 
 GLint Shader::getUniformId(const std::string& name) {
-  auto cache = uniform_id_cache.find(name);
-  if (cache != uniform_id_cache.end()) return cache->second;
+  auto cache = current->uniform_id_cache.find(name);
+  if (cache != current->uniform_id_cache.end()) return cache->second;
 
-  GLint id = glGetUniformLocation(program, name.c_str());
+  GLint id = glGetUniformLocation(current->id, name.c_str());
 
   if (id == -1)
     LOG_WARN("shader - GL uniform object [{}] can't be found.", name);
   else
-    uniform_id_cache[name] = id;
+    current->uniform_id_cache[name] = id;
 
   return id;
 }
 
 GLint Shader::getAttribId(const std::string& name) {
-  auto cache = attrib_id_cache.find(name);
-  if (cache != attrib_id_cache.end()) return cache->second;
+  auto cache = current->attrib_id_cache.find(name);
+  if (cache != current->attrib_id_cache.end()) return cache->second;
 
-  GLint id = glGetAttribLocation(program, name.c_str());
+  GLint id = glGetAttribLocation(current->id, name.c_str());
 
   if (id == -1)
     LOG_WARN("shader - GL Attrib object [{}] can't be found.", name);
   else
-    attrib_id_cache[name] = id;
+    current->attrib_id_cache[name] = id;
 
   return id;
 }
 
 }  // namespace gl
-}  // namespace seg
\ No newline at end of file
+}  // namespace seg
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 
@@ -14,27 +16,107 @@ namespace gl {
 
 enum class ShaderType { GENERAL, GRID };
 
+// texture units of the samplers in shader.vert
+enum TextureUnit : GLint {
+  TEXTURE_UNIT_POSE_TABLE = 1,  // GL_TEXTURE_BUFFER
+};
+
+/**
+ * Uniforms of the programs in seg/gl/shader, resolved once per program.
+ * Names in uniformName(). Per frame values are in the Frame block instead.
+ * (see gl::FrameUniforms)
+ */
+enum class Uniform {
+  MODEL_MATRIX,
+  UNIFORM_COLOR,
+  POSE_TABLE,
+  VISUALIZE_HUE_FROM,
+  VISUALIZE_HUE_TO,
+  VISUALIZE_SATURATION,
+  VISUALIZE_VALUE,
+  VISUALIZE_Z_MIN,
+  VISUALIZE_Z_MAX,
+  GRID_COLOR,
+  GRID_FADE_DISTANCE,
+  COUNT,
+};
+const char* uniformName(Uniform uniform);
+
+// compile time options of a ShaderVariant, as defines in shader.vert.
+enum ShaderFeature : uint32_t {
+  SHADER_NONE = 0,
+  SHADER_INSTANCED = 1 << 0,       // instance attributes, 4 / 5
+  SHADER_INSTANCE_COLOR = 1 << 1,  // with INSTANCED, uniform color mode
+  SHADER_POSE_TABLE = 1 << 2,      // pose index attribute, 6
+};
+
+/**
+ * A specialization of the GENERAL program: a branch free vertex shader
+ * declaring only the attributes its color mode and features read.
+ */
+struct ShaderVariant {
+  ColorMode color_mode = ColorMode::UNIFORM;
+  uint32_t features = 0;  // ShaderFeature
+
+  ShaderVariant() {}
+  ShaderVariant(ColorMode _color_mode, uint32_t _features = 0)
+      : color_mode(_color_mode), features(_features) {}
+
+  // 6 bits, unique per variant
+  uint32_t key() const {
+    return static_cast<uint32_t>(color_mode) << 3 | (features & 0x7);
+  }
+};
+
+/**
+ * Programs of one ShaderType. GENERAL keeps one program per ShaderVariant,
+ * compiled on first bind (plain color modes at init); GRID has one.
+ * setUniform() goes to the program bound last.
+ */
 class Shader {
  public:
   Shader() {};
   ~Shader();
   void init(ShaderType type);
 
+  // default variant, ColorMode::UNIFORM without features.
   void bind();
+  /**
+   * @brief Binds the program of variant, compiling it first if needed.
+   *        Uniforms are per program; set them after binding.
+   * @throw std::runtime_error if compiling fails.
+   */
+  void bind(const ShaderVariant& variant);
   void unbind();
 
   ShaderType getType() const { return type; }
+  size_t variantCount() const { return programs.size(); }
   GLint getUniformId(const std::string& name);
   GLint getAttribId(const std::string& name);
 
   inline void setModelMatrix(const Eigen::Matrix4f& model_matrix) {
-    setUniform("model_matrix", model_matrix);
+    setUniform(Uniform::MODEL_MATRIX, model_matrix);
   }
 
-  inline void setColorMode(const ColorMode mode) {
-    setUniform("color_mode", static_cast<int>(mode));
+  // -1 if the program has no such uniform, setting it is then a no-op.
+  GLint getUniformId(Uniform uniform) const {
+    return current->uniform_ids[static_cast<size_t>(uniform)];
   }
 
+  inline void setUniform(Uniform uniform, int value) {
+    glUniform1i(getUniformId(uniform), value);
+  }
+  inline void setUniform(Uniform uniform, float value) {
+    glUniform1f(getUniformId(uniform), value);
+  }
+  inline void setUniform(Uniform uniform, const Eigen::Vector4f& value) {
+    glUniform4fv(getUniformId(uniform), 1, value.data());
+  }
+  inline void setUniform(Uniform uniform, const Eigen::Matrix4f& value) {
+    glUniformMatrix4fv(getUniformId(uniform), 1, GL_FALSE, value.data());
+  }
+
+  // by name, looked up in a hash map. for uniforms without a Uniform.
   inline void setUniform(const std::string& name, int value) {
     glUniform1i(getUniformId(name), value);
   }
@@ -59,13 +141,21 @@ class Shader {
   }
 
  private:
-  void attatchShader(const std::string& vert_src, const std::string& frag_src);
-  void setDefaultSettings();
+  struct Program {
+    GLuint id = 0;
+    std::array<GLint, static_cast<size_t>(Uniform::COUNT)> uniform_ids;
+    std::unordered_map<std::string, GLint> uniform_id_cache;
+    std::unordered_map<std::string, GLint> attrib_id_cache;
+  };
+
+  Program& variant(const ShaderVariant& variant);
+  GLuint compile(const std::string& defines);
+  void resolveUniforms(Program& program);
+  void setDefaultSettings(Program& program);
 
   ShaderType type = ShaderType::GENERAL;
-  GLuint program = 0;
-  std::unordered_map<std::string, GLint> uniform_id_cache;
-  std::unordered_map<std::string, GLint> attrib_id_cache;
+  std::unordered_map<uint32_t, Program> programs;  // by ShaderVariant::key()
+  Program* current = nullptr;
 
 };  // class Shader
 }  // namespace gl
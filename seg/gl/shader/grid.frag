@@ -1,11 +1,15 @@
-R"(#version 330
+R"(
 
 in vec3 near_point;
 in vec3 far_point;
 
 out vec4 frag_color;
 
-uniform mat4 vp_matrix;
+// per frame, gl::FrameUniforms (uniform_buffer.h)
+layout(std140) uniform Frame {
+    mat4 vp_matrix;
+    mat4 inv_vp_matrix;
+};
 uniform vec4 grid_color;
 uniform float grid_fade_distance;
 
@@ -1,9 +1,13 @@
-R"(#version 330
+R"(
 
 out vec3 near_point;
 out vec3 far_point;
 
-uniform mat4 inv_vp_matrix;
+// per frame, gl::FrameUniforms (uniform_buffer.h)
+layout(std140) uniform Frame {
+    mat4 vp_matrix;
+    mat4 inv_vp_matrix;
+};
 
 // fullscreen quad vertices (two triangles)
 const vec3 quad[6] = vec3[](
@@ -1,4 +1,4 @@
-R"(#version 330
+R"(
 
 in vec4 fragment_color;
 
@@ -1,25 +1,62 @@
-R"(#version 330
+R"(
+// specialized by defines Shader puts before this (see gl::ShaderVariant)
+//   COLOR_MODE      seg::ColorMode, 0 - 4
+//   INSTANCED       per instance pose, CompactPose / InstanceAttributes
+//   INSTANCE_COLOR  per instance color instead of uniform_color
+//   POSE_TABLE      per vertex index into pose_table
 uniform mat4 model_matrix;
-uniform mat4 vp_matrix;
 
-uniform int color_mode;
+// per frame, gl::FrameUniforms (uniform_buffer.h)
+layout(std140) uniform Frame {
+    mat4 vp_matrix;
+    mat4 inv_vp_matrix;
+};
+
+#if COLOR_MODE == 0 && !defined(INSTANCE_COLOR)
 uniform vec4 uniform_color;
+#endif
 
+#if COLOR_MODE == 3 || COLOR_MODE == 4
 uniform float visualize_hue_from;
 uniform float visualize_hue_to;
 uniform float visualize_saturation;
 uniform float visualize_value;
+#endif
 
+#if COLOR_MODE == 4
 uniform float visualize_z_min;
 uniform float visualize_z_max;
+#endif
+
+// must match gl::AttributeLocation (vertex_layout.h)
+// compact formats feed vertex_pos_model as -1..1 inside its chunk; the chunk
+// origin / scale are part of model_matrix, so world_pos is decoded below.
+layout(location = 0) in vec3 vertex_pos_model;
+#if COLOR_MODE == 1
+layout(location = 1) in vec3 vertex_color_rgb;
+#elif COLOR_MODE == 2
+layout(location = 2) in vec4 vertex_color_rgba;
+#elif COLOR_MODE == 3
+layout(location = 3) in float vertex_intensity;
+#endif
 
-in vec3 vertex_pos_model;
-in vec3 vertex_color_rgb;
-in vec4 vertex_color_rgba;
-in float vertex_intensity;
+#ifdef INSTANCED
+layout(location = 4) in vec4 instance_rotation;  // quaternion xyzw
+layout(location = 5) in vec4 instance_translation;  // xyz, uniform scale
+#ifdef INSTANCE_COLOR
+layout(location = 7) in vec4 instance_color;
+#endif
+#endif
+
+#ifdef POSE_TABLE
+// CompactPose per entry, 2 texels: rotation xyzw, translation xyz_
+uniform samplerBuffer pose_table;
+layout(location = 6) in float vertex_pose_index;
+#endif
 
 out vec4 fragment_color;
 
+#if COLOR_MODE == 3 || COLOR_MODE == 4
 // "hsv2rgb_smooth"
 // The MIT License
 // Copyright © 2014 Inigo Quilez
@@ -28,7 +65,7 @@ vec3 hsv2rgb_smooth( in vec3 hsv )
 {
     vec3 rgb = clamp( abs(mod(hsv.x*6.0+vec3(0.0,4.0,2.0),6.0)-3.0)-1.0, 0.0, 1.0 );
 
-	rgb = rgb*rgb*(3.0-2.0*rgb); // cubic smoothing	
+	rgb = rgb*rgb*(3.0-2.0*rgb); // cubic smoothing
 
 	return hsv.z * mix( vec3(1.0), rgb, hsv.y);
 }
@@ -39,30 +76,37 @@ vec3 float2rgb(in float value, in float value_min, in float value_max)
     float hue = (value - value_min)/(value_max - value_min) * (visualize_hue_to - visualize_hue_from) + visualize_hue_from;
     return hsv2rgb_smooth(vec3(hue,visualize_saturation, visualize_value));
 }
+#endif
+
+vec3 rotate(in vec4 q, in vec3 v)
+{
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
 
 void main(){
-    vec4 world_pos = model_matrix * vec4(vertex_pos_model,1);
+    vec3 pos = vertex_pos_model;
+#if defined(POSE_TABLE)
+    int entry = 2 * int(vertex_pose_index);
+    pos = rotate(texelFetch(pose_table, entry), pos) + texelFetch(pose_table, entry + 1).xyz;
+#elif defined(INSTANCED)
+    pos = rotate(instance_rotation, pos) * instance_translation.w + instance_translation.xyz;
+#endif
+
+    vec4 world_pos = model_matrix * vec4(pos,1);
     gl_Position = vp_matrix * world_pos;
 
-    if(color_mode == 0)
-    {
-        fragment_color = uniform_color;
-    }
-    else if(color_mode == 1) // rgb
-    {
-        fragment_color = vec4(vertex_color_rgb,1);
-    }
-    else if(color_mode == 2) // rgba
-    {
-        fragment_color = vertex_color_rgba;
-    }
-    else if(color_mode == 3) // scalar
-    {
-        fragment_color = vec4(float2rgb(vertex_intensity,0,255),1);
-    }
-    else if(color_mode == 4) // z axis
-    {
-        fragment_color = vec4(float2rgb(world_pos.z, visualize_z_min, visualize_z_max),1);
-    }
+#if COLOR_MODE == 0 && defined(INSTANCE_COLOR)
+    fragment_color = instance_color;
+#elif COLOR_MODE == 0
+    fragment_color = uniform_color;
+#elif COLOR_MODE == 1 // rgb
+    fragment_color = vec4(vertex_color_rgb,1);
+#elif COLOR_MODE == 2 // rgba
+    fragment_color = vertex_color_rgba;
+#elif COLOR_MODE == 3 // scalar
+    fragment_color = vec4(float2rgb(vertex_intensity,0,255),1);
+#elif COLOR_MODE == 4 // z axis
+    fragment_color = vec4(float2rgb(world_pos.z, visualize_z_min, visualize_z_max),1);
+#endif
 }
-)"
\ No newline at end of file
+)"
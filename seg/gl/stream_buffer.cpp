@@ -0,0 +1,276 @@
+#include "seg/gl/stream_buffer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include <GL/glew.h>
+
+#include "seg/core/stats.h"
+#include "seg/internal/logger.h"
+
+namespace {
+// keeps ring slots aligned for any vertex attribute / index type.
+const size_t SLOT_ALIGNMENT = 256;
+const size_t MIN_RING_CAPACITY = 4096;
+const GLbitfield RING_FLAGS =
+    GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+const GLuint64 FENCE_TIMEOUT_NS = 1000000000;  // 1 second
+
+size_t alignUp(size_t value, size_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+class UploadTimer {
+ public:
+  UploadTimer(size_t _bytes)
+      : bytes(_bytes), start(std::chrono::steady_clock::now()) {}
+  ~UploadTimer() {
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    seg::core::Stats::getInstance().addUpload(bytes, elapsed.count());
+  }
+
+ private:
+  size_t bytes;
+  std::chrono::steady_clock::time_point start;
+};
+}  // namespace
+
+namespace seg {
+namespace gl {
+bool StreamBuffer::persistentMappingSupported() {
+  return GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage;
+}
+
+void StreamBuffer::prepareUpload(size_t bytes) {
+  if (policy == UploadPolicy::AUTO)
+    policy = persistentMappingSupported() ? UploadPolicy::PERSISTENT_RING
+                                          : UploadPolicy::ORPHAN;
+
+  if (policy == UploadPolicy::PERSISTENT_RING &&
+      persistentMappingSupported() == false) {
+    LOG_WARN("StreamBuffer - persistent mapping unsupported, orphaning.");
+    policy = UploadPolicy::ORPHAN;
+  }
+
+  if (policy == UploadPolicy::REALLOCATE) {
+    if (buffer == 0) glGenBuffers(1, &buffer);
+  } else if (buffer == 0 || capacity < bytes)
+    allocate(std::max(bytes, capacity * 2));
+  else if (policy == UploadPolicy::PERSISTENT_RING)
+    advanceSlot();
+}
+
+void StreamBuffer::upload(const void* data, size_t bytes) {
+  UploadTimer timer(bytes);
+  prepareUpload(bytes);
+
+  switch (policy) {
+    case UploadPolicy::PERSISTENT_RING:
+      if (bytes != 0) std::memcpy(mapped + slot_offset, data, bytes);
+      break;
+    case UploadPolicy::ORPHAN:
+      glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+      // orphan: the driver hands out fresh storage while the gpu may still
+      // read the old one, then reuses it. no reallocation from our side.
+      glBufferData(GL_COPY_WRITE_BUFFER, capacity, nullptr, usage);
+      glBufferSubData(GL_COPY_WRITE_BUFFER, 0, bytes, data);
+      break;
+    case UploadPolicy::REALLOCATE:
+    default:
+      glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+      glBufferData(GL_COPY_WRITE_BUFFER, bytes, data, usage);
+      capacity = bytes;
+      break;
+  }
+
+  used = bytes;
+}
+
+void StreamBuffer::upload(size_t bytes,
+                          const std::function<void(void*)>& fill) {
+  UploadTimer timer(bytes);
+  prepareUpload(bytes);
+  used = bytes;
+
+  if (policy == UploadPolicy::PERSISTENT_RING) {
+    if (bytes != 0) fill(mapped + slot_offset);
+    return;
+  }
+
+  glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+  if (policy == UploadPolicy::ORPHAN)
+    glBufferData(GL_COPY_WRITE_BUFFER, capacity, nullptr, usage);
+  else {
+    glBufferData(GL_COPY_WRITE_BUFFER, bytes, nullptr, usage);
+    capacity = bytes;
+  }
+
+  if (bytes == 0) return;
+
+  void* out = glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, bytes,
+                               GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+  if (out == nullptr) {
+    LOG_ERROR("StreamBuffer - glMapBufferRange failed.");
+    used = 0;
+    return;
+  }
+  fill(out);
+  if (glUnmapBuffer(GL_COPY_WRITE_BUFFER) == GL_FALSE) {
+    LOG_WARN("StreamBuffer - buffer contents lost while mapped.");
+    used = 0;
+  }
+}
+
+void StreamBuffer::append(const void* data, size_t bytes) {
+  UploadTimer timer(bytes);
+
+  if (buffer == 0 || capacity < used + bytes)
+    grow(std::max(used + bytes, capacity * 2));
+
+  // gpu reads only [offset, offset + used) -> writing past it never races.
+  if (mapped != nullptr)
+    std::memcpy(mapped + slot_offset + used, data, bytes);
+  else {
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, slot_offset + used, bytes, data);
+  }
+
+  used += bytes;
+}
+
+void StreamBuffer::patch(const std::vector<Range>& ranges, const void* data) {
+  if (buffer == 0 || ranges.empty()) return;
+
+  size_t total = 0;
+  for (const auto& range : ranges) total += range.bytes;
+  UploadTimer timer(total);
+
+  const auto* src = static_cast<const unsigned char*>(data);
+
+  if (mapped == nullptr) {
+    // driver orders glBufferSubData after draws already reading the buffer.
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    for (const auto& range : ranges) {
+      if (range.offset + range.bytes <= used)
+        glBufferSubData(GL_COPY_WRITE_BUFFER, slot_offset + range.offset,
+                        range.bytes, src);
+      src += range.bytes;
+    }
+    return;
+  }
+
+  // ring: cpu writes through the mapping would race frames in flight, so
+  // dirty bytes go through a staging buffer and are copied into the current
+  // slot on the gpu. the copies are ordered after the draws already
+  // submitted, like glBufferSubData; cost follows the dirty bytes only.
+  if (staging == 0) glGenBuffers(1, &staging);
+  glBindBuffer(GL_COPY_READ_BUFFER, staging);
+  glBufferData(GL_COPY_READ_BUFFER, total, data, GL_STREAM_DRAW);
+
+  glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+  size_t staged = 0;
+  for (const auto& range : ranges) {
+    if (range.offset + range.bytes <= used)
+      glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, staged,
+                          slot_offset + range.offset, range.bytes);
+    staged += range.bytes;
+  }
+}
+
+void StreamBuffer::free() {
+  if (staging != 0) glDeleteBuffers(1, &staging);
+  staging = 0;
+
+  if (buffer == 0) return;
+
+  releaseRing();
+  glDeleteBuffers(1, &buffer);
+  buffer = 0;
+  capacity = 0;
+  used = 0;
+  slot_offset = 0;
+}
+
+void StreamBuffer::allocate(size_t _capacity) {
+  free();
+  glGenBuffers(1, &buffer);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+
+  if (policy == UploadPolicy::PERSISTENT_RING) {
+    capacity = alignUp(std::max(_capacity, MIN_RING_CAPACITY), SLOT_ALIGNMENT);
+    glBufferStorage(GL_COPY_WRITE_BUFFER, capacity * RING_SLOTS, nullptr,
+                    RING_FLAGS);
+    mapped = static_cast<unsigned char*>(glMapBufferRange(
+        GL_COPY_WRITE_BUFFER, 0, capacity * RING_SLOTS, RING_FLAGS));
+    slot = 0;
+  } else {
+    capacity = _capacity;
+    glBufferData(GL_COPY_WRITE_BUFFER, capacity, nullptr, usage);
+  }
+
+  slot_offset = 0;
+}
+
+void StreamBuffer::grow(size_t _capacity) {
+  const GLuint old_buffer = buffer;
+  const size_t old_offset = slot_offset;
+  const size_t old_used = used;
+
+  // detach old storage so allocate() does not delete it yet.
+  releaseRing();
+  buffer = 0;
+  allocate(_capacity);
+
+  // gpu-side copy of resident contents, no round trip through cpu memory
+  if (old_buffer != 0) {
+    if (old_used != 0) {
+      glBindBuffer(GL_COPY_READ_BUFFER, old_buffer);
+      glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                          old_offset, slot_offset, old_used);
+    }
+    glDeleteBuffers(1, &old_buffer);
+  }
+
+  used = old_used;
+}
+
+void StreamBuffer::releaseRing() {
+  for (auto& fence : fences) {
+    if (fence != nullptr) glDeleteSync(fence);
+    fence = nullptr;
+  }
+
+  if (mapped != nullptr) {
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+    mapped = nullptr;
+  }
+}
+
+void StreamBuffer::advanceSlot() {
+  // every draw reading the current slot is already submitted -> fence it.
+  if (fences[slot] != nullptr) glDeleteSync(fences[slot]);
+  fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+  slot = (slot + 1) % RING_SLOTS;
+  slot_offset = capacity * slot;
+
+  if (fences[slot] == nullptr) return;
+
+  GLenum state = glClientWaitSync(fences[slot], 0, 0);
+  if (state == GL_TIMEOUT_EXPIRED) {
+    core::Stats::getInstance().addUploadStall();
+    state = glClientWaitSync(fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT,
+                             FENCE_TIMEOUT_NS);
+    if (state == GL_TIMEOUT_EXPIRED)
+      LOG_WARN("StreamBuffer - gpu fence timeout, writing anyway.");
+  }
+
+  glDeleteSync(fences[slot]);
+  fences[slot] = nullptr;
+}
+
+}  // namespace gl
+}  // namespace seg
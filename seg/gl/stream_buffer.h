@@ -0,0 +1,114 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "seg/options.h"  // seg::UploadPolicy
+
+namespace seg {
+namespace gl {
+/**
+ * GL buffer with a policy driven upload path. (see seg::UploadPolicy)
+ * Contents live at offset() inside id(); callers must bind with that offset,
+ * since ring slots move the current region on every upload.
+ * All functions must be called from the gl thread.
+ */
+class StreamBuffer {
+ public:
+  static const int RING_SLOTS = 3;
+
+  StreamBuffer(UploadPolicy _policy, GLenum _usage)
+      : policy(_policy), usage(_usage) {}
+  StreamBuffer(const StreamBuffer&) = delete;
+  StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+  // replaces contents.
+  void upload(const void* data, size_t bytes);
+  // replaces contents, fill writes them straight into mapped storage.
+  void upload(size_t bytes, const std::function<void(void*)>& fill);
+  // extends contents, keeping what is already resident.
+  void append(const void* data, size_t bytes);
+
+  struct Range {
+    size_t offset;  // within contents
+    size_t bytes;
+  };
+  /**
+   * Overwrites ranges of resident contents. data holds the ranges back to
+   * back. Only those bytes are sent from the cpu.
+   */
+  void patch(const std::vector<Range>& ranges, const void* data);
+
+  /**
+   * patch() for an array of T, from (index, element) pairs in any order.
+   * Duplicate indices resolve to the last one; neighbours are coalesced.
+   */
+  template <typename T>
+  void patch(std::vector<std::pair<size_t, T>>& elements);
+  void free();
+
+  GLuint id() const { return buffer; }
+  size_t offset() const { return slot_offset; }
+  size_t size() const { return used; }
+  UploadPolicy getPolicy() const { return policy; }
+
+  static bool persistentMappingSupported();
+
+ private:
+  void prepareUpload(size_t bytes);
+  void allocate(size_t capacity);
+  void grow(size_t capacity);
+  void releaseRing();
+  void advanceSlot();
+
+  UploadPolicy policy;
+  const GLenum usage;
+
+  GLuint buffer = 0;
+  size_t capacity = 0;  // bytes, per slot
+  size_t used = 0;      // bytes
+  size_t slot_offset = 0;
+
+  // PERSISTENT_RING only
+  int slot = 0;
+  unsigned char* mapped = nullptr;
+  GLsync fences[RING_SLOTS] = {};
+  GLuint staging = 0;  // patch source
+
+};  // class StreamBuffer
+
+template <typename T>
+void StreamBuffer::patch(std::vector<std::pair<size_t, T>>& elements) {
+  if (elements.empty()) return;
+
+  std::stable_sort(
+      elements.begin(), elements.end(),
+      [](const auto& a, const auto& b) { return a.first < b.first; });
+
+  std::vector<Range> ranges;
+  std::vector<T> data;
+  data.reserve(elements.size());
+
+  for (size_t i = 0; i < elements.size(); i++) {
+    // latest write of an index wins
+    if (i + 1 < elements.size() && elements[i + 1].first == elements[i].first)
+      continue;
+
+    const size_t offset = sizeof(T) * elements[i].first;
+    if (ranges.empty() == false &&
+        ranges.back().offset + ranges.back().bytes == offset)
+      ranges.back().bytes += sizeof(T);
+    else
+      ranges.push_back({offset, sizeof(T)});
+    data.push_back(elements[i].second);
+  }
+
+  patch(ranges, data.data());
+}
+}  // namespace gl
+}  // namespace seg
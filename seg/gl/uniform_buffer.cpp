@@ -0,0 +1,30 @@
+#include "seg/gl/uniform_buffer.h"
+
+#include <GL/glew.h>
+
+namespace seg {
+namespace gl {
+FrameUniformBuffer::~FrameUniformBuffer() {
+  if (buffer != 0) glDeleteBuffers(1, &buffer);
+}
+
+void FrameUniformBuffer::init() {
+  static_assert(sizeof(FrameUniforms) == sizeof(float) * 32,
+                "FrameUniforms must match the std140 Frame block");
+
+  glGenBuffers(1, &buffer);
+  glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+  glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniforms), nullptr,
+               GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+  glBindBufferBase(GL_UNIFORM_BUFFER, UNIFORM_BLOCK_FRAME, buffer);
+}
+
+void FrameUniformBuffer::update(const FrameUniforms& values) {
+  glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+  glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameUniforms), &values);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+}  // namespace gl
+}  // namespace seg
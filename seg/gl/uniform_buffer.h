@@ -0,0 +1,42 @@
+#pragma once
+
+#include <Eigen/Dense>
+#include <GL/glew.h>
+
+namespace seg {
+namespace gl {
+// binding points of the uniform blocks in seg/gl/shader
+enum UniformBlockBinding : GLuint {
+  UNIFORM_BLOCK_FRAME = 0,
+};
+
+/**
+ * Values of one frame shared by every program, the std140 "Frame" block.
+ * Only vec4 / mat4 members, which std140 lays out as in c++.
+ */
+struct FrameUniforms {
+  Eigen::Matrix4f vp_matrix = Eigen::Matrix4f::Identity();
+  Eigen::Matrix4f inv_vp_matrix = Eigen::Matrix4f::Identity();
+};
+
+/**
+ * FrameUniforms in a uniform buffer at UNIFORM_BLOCK_FRAME, written once
+ * per frame instead of once per program.
+ * gl thread only.
+ */
+class FrameUniformBuffer {
+ public:
+  FrameUniformBuffer() {}
+  ~FrameUniformBuffer();
+  FrameUniformBuffer(const FrameUniformBuffer&) = delete;
+  FrameUniformBuffer& operator=(const FrameUniformBuffer&) = delete;
+
+  void init();
+  void update(const FrameUniforms& values);
+
+ private:
+  GLuint buffer = 0;
+
+};  // class FrameUniformBuffer
+}  // namespace gl
+}  // namespace seg
@@ -0,0 +1,369 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include <Eigen/Dense>
+#include <GL/glew.h>
+
+#include "seg/attribute_view.h"
+#include "seg/types.h"  // seg::CompactPose
+
+namespace seg {
+namespace gl {
+// IEEE half float, storage only. (GL_HALF_FLOAT)
+struct Half {
+  uint16_t bits;
+};
+
+// fixed attribute locations, must match layout(location) in shader.vert
+enum AttributeLocation : GLuint {
+  ATTRIB_POSITION = 0,
+  ATTRIB_COLOR_RGB = 1,
+  ATTRIB_COLOR_RGBA = 2,
+  ATTRIB_SCALAR = 3,
+  ATTRIB_INSTANCE_ROTATION = 4,     // quaternion xyzw
+  ATTRIB_INSTANCE_TRANSLATION = 5,  // xyz, uniform scale
+  ATTRIB_POSE_INDEX = 6,            // entry of the pose table
+  ATTRIB_INSTANCE_COLOR = 7,        // rgba
+};
+
+/**
+ * One instance of automatic instancing (see object::ObjectManager), 48 B.
+ * A similarity transform, rotation / uniform scale / translation, and color.
+ */
+struct InstanceAttributes {
+  float rotation[4];     // quaternion x, y, z, w
+  float translation[4];  // x, y, z, scale
+  float color[4];
+};
+
+/**
+ * Vertex layout policies for gl::Renderer.
+ * Each layout is one interleaved vertex struct; which attributes exist is
+ * known at compile time, so packing and attribute setup carry no branches.
+ *
+ * Compact* layouts store positions as int16, normalized to the bounding box
+ * of the chunk they belong to (see GeneralRenderer::Chunk), colors as uint8
+ * and scalars as uint8 / half float.
+ *
+ * Indexed* layouts carry the index of a pose table entry that places the
+ * vertex (see object::ScanMap). It is stored as float, exact up to 2^24.
+ */
+namespace layout {
+struct Position {
+  struct Vertex {
+    float position[3];
+  };
+  static constexpr bool has_color = false;
+  static constexpr bool has_scalar = false;
+  static constexpr bool quantized = false;
+  static constexpr bool has_pose_index = false;
+};
+
+struct PositionColor {
+  struct Vertex {
+    float position[3];
+    float color[3];
+  };
+  static constexpr bool has_color = true;
+  static constexpr bool has_scalar = false;
+  static constexpr bool quantized = false;
+  static constexpr bool has_pose_index = false;
+};
+
+struct PositionScalar {
+  struct Vertex {
+    float position[3];
+    float scalar[1];
+  };
+  static constexpr bool has_color = false;
+  static constexpr bool has_scalar = true;
+  static constexpr bool quantized = false;
+  static constexpr bool has_pose_index = false;
+};
+
+struct PositionColorScalar {
+  struct Vertex {
+    float position[3];
+    float color[3];
+    float scalar[1];
+  };
+  static constexpr bool has_color = true;
+  static constexpr bool has_scalar = true;
+  static constexpr bool quantized = false;
+  static constexpr bool has_pose_index = false;
+};
+
+// 8 B
+struct CompactPosition {
+  struct alignas(4) Vertex {
+    int16_t position[3];
+  };
+  static constexpr bool has_color = false;
+  static constexpr bool has_scalar = false;
+  static constexpr bool quantized = true;
+  static constexpr bool has_pose_index = false;
+};
+
+// 12 B
+struct CompactPositionColor {
+  struct alignas(4) Vertex {
+    int16_t position[3];
+    uint8_t color[3];
+  };
+  static constexpr bool has_color = true;
+  static constexpr bool has_scalar = false;
+  static constexpr bool quantized = true;
+  static constexpr bool has_pose_index = false;
+};
+
+// 8 B, Scalar - uint8_t / Half
+template <typename Scalar>
+struct CompactPositionScalar {
+  struct alignas(4) Vertex {
+    int16_t position[3];
+    Scalar scalar[1];
+  };
+  static constexpr bool has_color = false;
+  static constexpr bool has_scalar = true;
+  static constexpr bool quantized = true;
+  static constexpr bool has_pose_index = false;
+};
+
+// 12 B, Scalar - uint8_t / Half
+template <typename Scalar>
+struct CompactPositionColorScalar {
+  struct alignas(4) Vertex {
+    int16_t position[3];
+    Scalar scalar[1];
+    uint8_t color[3];
+  };
+  static constexpr bool has_color = true;
+  static constexpr bool has_scalar = true;
+  static constexpr bool quantized = true;
+  static constexpr bool has_pose_index = false;
+};
+
+// 20 B
+struct IndexedPositionScalar {
+  struct Vertex {
+    float position[3];
+    float scalar[1];
+    float pose_index[1];
+  };
+  static constexpr bool has_color = false;
+  static constexpr bool has_scalar = true;
+  static constexpr bool quantized = false;
+  static constexpr bool has_pose_index = true;
+};
+}  // namespace layout
+
+// ======================================================================
+template <typename T>
+struct GLType;
+template <>
+struct GLType<float> : std::integral_constant<GLenum, GL_FLOAT> {};
+template <>
+struct GLType<int16_t> : std::integral_constant<GLenum, GL_SHORT> {};
+template <>
+struct GLType<uint16_t> : std::integral_constant<GLenum, GL_UNSIGNED_SHORT> {};
+template <>
+struct GLType<uint8_t> : std::integral_constant<GLenum, GL_UNSIGNED_BYTE> {};
+template <>
+struct GLType<Half> : std::integral_constant<GLenum, GL_HALF_FLOAT> {};
+
+/**
+ * Points attribute at one member array of an interleaved vertex.
+ * normalized - integer members read back as 0..1 / -1..1, else as is.
+ */
+template <typename Vertex, typename Member>
+void setupAttribute(GLuint location, size_t offset, GLboolean normalized) {
+  using T = std::remove_all_extents_t<Member>;
+  constexpr GLint count = sizeof(Member) / sizeof(T);
+
+  glEnableVertexAttribArray(location);
+  glVertexAttribPointer(location, count, GLType<T>::value, normalized,
+                        sizeof(Vertex), (void*)offset);
+}
+
+// bound GL_ARRAY_BUFFER + base offset -> vao attribute state.
+template <typename Layout>
+void setupAttributes(size_t base_offset) {
+  using Vertex = typename Layout::Vertex;
+
+  // scalars are never normalized; uint8 keeps the 0 - 255 range as is.
+  setupAttribute<Vertex, decltype(Vertex::position)>(
+      ATTRIB_POSITION, base_offset + offsetof(Vertex, position),
+      Layout::quantized);
+  if constexpr (Layout::has_color)
+    setupAttribute<Vertex, decltype(Vertex::color)>(
+        ATTRIB_COLOR_RGB, base_offset + offsetof(Vertex, color),
+        std::is_integral_v<std::remove_all_extents_t<decltype(Vertex::color)>>);
+  if constexpr (Layout::has_scalar)
+    setupAttribute<Vertex, decltype(Vertex::scalar)>(
+        ATTRIB_SCALAR, base_offset + offsetof(Vertex, scalar), GL_FALSE);
+  if constexpr (Layout::has_pose_index)
+    setupAttribute<Vertex, decltype(Vertex::pose_index)>(
+        ATTRIB_POSE_INDEX, base_offset + offsetof(Vertex, pose_index),
+        GL_FALSE);
+}
+
+/**
+ * Bound GL_ARRAY_BUFFER of CompactPose -> per instance attributes.
+ * Detached (nothing bound), the instance attributes read the generic
+ * attribute values, which Shader sets to identity. Translation w is left
+ * out, so it reads as scale 1.
+ */
+inline void setupInstanceAttributes(size_t base_offset) {
+  glEnableVertexAttribArray(ATTRIB_INSTANCE_ROTATION);
+  glVertexAttribPointer(ATTRIB_INSTANCE_ROTATION, 4, GL_FLOAT, GL_FALSE,
+                        sizeof(CompactPose),
+                        (void*)(base_offset + offsetof(CompactPose, rotation)));
+  glVertexAttribDivisor(ATTRIB_INSTANCE_ROTATION, 1);
+
+  glEnableVertexAttribArray(ATTRIB_INSTANCE_TRANSLATION);
+  glVertexAttribPointer(
+      ATTRIB_INSTANCE_TRANSLATION, 3, GL_FLOAT, GL_FALSE, sizeof(CompactPose),
+      (void*)(base_offset + offsetof(CompactPose, translation)));
+  glVertexAttribDivisor(ATTRIB_INSTANCE_TRANSLATION, 1);
+
+  glDisableVertexAttribArray(ATTRIB_INSTANCE_COLOR);
+}
+
+// Bound GL_ARRAY_BUFFER of InstanceAttributes -> per instance attributes.
+inline void setupInstanceAttributesWithColor(size_t base_offset) {
+  const GLsizei stride = sizeof(InstanceAttributes);
+
+  glEnableVertexAttribArray(ATTRIB_INSTANCE_ROTATION);
+  glVertexAttribPointer(
+      ATTRIB_INSTANCE_ROTATION, 4, GL_FLOAT, GL_FALSE, stride,
+      (void*)(base_offset + offsetof(InstanceAttributes, rotation)));
+  glVertexAttribDivisor(ATTRIB_INSTANCE_ROTATION, 1);
+
+  glEnableVertexAttribArray(ATTRIB_INSTANCE_TRANSLATION);
+  glVertexAttribPointer(
+      ATTRIB_INSTANCE_TRANSLATION, 4, GL_FLOAT, GL_FALSE, stride,
+      (void*)(base_offset + offsetof(InstanceAttributes, translation)));
+  glVertexAttribDivisor(ATTRIB_INSTANCE_TRANSLATION, 1);
+
+  glEnableVertexAttribArray(ATTRIB_INSTANCE_COLOR);
+  glVertexAttribPointer(
+      ATTRIB_INSTANCE_COLOR, 4, GL_FLOAT, GL_FALSE, stride,
+      (void*)(base_offset + offsetof(InstanceAttributes, color)));
+  glVertexAttribDivisor(ATTRIB_INSTANCE_COLOR, 1);
+}
+
+inline void detachInstanceAttributes() {
+  glDisableVertexAttribArray(ATTRIB_INSTANCE_ROTATION);
+  glDisableVertexAttribArray(ATTRIB_INSTANCE_TRANSLATION);
+  glDisableVertexAttribArray(ATTRIB_INSTANCE_COLOR);
+}
+
+// Attribute encoders ===================================================
+inline uint16_t toHalf(float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+
+  const uint16_t sign = (bits >> 16) & 0x8000;
+  const int exponent = static_cast<int>((bits >> 23) & 0xff) - 127 + 15;
+  const uint32_t mantissa = bits & 0x7fffff;
+
+  if (exponent <= 0) return sign;            // flush denormals to zero
+  if (exponent >= 31) return sign | 0x7c00;  // inf
+
+  // round half up, a carry into the exponent is still correct.
+  uint16_t half = sign | (exponent << 10) | (mantissa >> 13);
+  if (mantissa & 0x1000) half++;
+  return half;
+}
+
+// position - quantized layouts expect it normalized to -1..1 already.
+inline void encodePosition(float* out, const Eigen::Vector3f& position) {
+  for (int k = 0; k < 3; k++) out[k] = position[k];
+}
+inline void encodePosition(int16_t* out, const Eigen::Vector3f& position) {
+  for (int k = 0; k < 3; k++) {
+    float v = std::min(std::max(position[k], -1.0f), 1.0f);
+    out[k] = static_cast<int16_t>(std::lround(v * 32767.0f));
+  }
+}
+
+inline void encodeColor(float* out, const Eigen::Vector3f& color) {
+  for (int k = 0; k < 3; k++) out[k] = color[k];
+}
+inline void encodeColor(uint8_t* out, const Eigen::Vector3f& color) {
+  for (int k = 0; k < 3; k++) {
+    float v = std::min(std::max(color[k], 0.0f), 1.0f);
+    out[k] = static_cast<uint8_t>(std::lround(v * 255.0f));
+  }
+}
+
+// shader visualizes scalars in 0 - 255, compact formats keep that range.
+inline void encodeScalar(float* out, float scalar) { out[0] = scalar; }
+inline void encodeScalar(uint8_t* out, float scalar) {
+  out[0] = static_cast<uint8_t>(
+      std::lround(std::min(std::max(scalar, 0.0f), 255.0f)));
+}
+inline void encodeScalar(Half* out, float scalar) {
+  out[0].bits = toHalf(std::min(std::max(scalar, 0.0f), 255.0f));
+}
+
+/**
+ * One vertex of Layout. color / scalar may be nullptr, then zero filled.
+ */
+template <typename Layout>
+void packVertex(typename Layout::Vertex& out,
+                const Eigen::Vector3f& position,
+                const Eigen::Vector3f* color,
+                const float* scalar) {
+  encodePosition(out.position, position);
+  if constexpr (Layout::has_color)
+    encodeColor(out.color, color ? *color : Eigen::Vector3f(0, 0, 0));
+  if constexpr (Layout::has_scalar)
+    encodeScalar(out.scalar, scalar ? *scalar : 0.0f);
+}
+
+/**
+ * SoA -> interleaved. colors / scalars may be nullptr, then zero filled.
+ */
+template <typename Layout>
+void pack(typename Layout::Vertex* out,
+          const Eigen::Vector3f* vertices,
+          const Eigen::Vector3f* colors,
+          const float* scalars,
+          size_t count) {
+  for (size_t i = 0; i < count; i++)
+    packVertex<Layout>(out[i], vertices[i], colors ? colors + i : nullptr,
+                       scalars ? scalars + i : nullptr);
+}
+
+// AttributeView readers ===============================================
+template <typename T>
+inline const T* element(const AttributeView& view, size_t i) {
+  const auto* base = static_cast<const unsigned char*>(view.data);
+  return reinterpret_cast<const T*>(base + view.stride * i);
+}
+
+template <typename T>
+inline Eigen::Vector3f readVector3(const AttributeView& view, size_t i) {
+  const T* e = element<T>(view, i);
+  return Eigen::Vector3f(static_cast<float>(e[0]), static_cast<float>(e[1]),
+                         static_cast<float>(e[2]));
+}
+
+// calls visitor with a T() tag of the component type of view.
+template <typename Visitor>
+void visitType(const AttributeView& view, Visitor&& visitor) {
+  if (view.type == AttributeView::Type::DOUBLE)
+    visitor(double());
+  else
+    visitor(float());
+}
+
+}  // namespace gl
+}  // namespace seg
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <Eigen/Dense>
+
+namespace seg {
+namespace gl {
+/**
+ * Camera state of the frame being drawn, updated by Scene before objects
+ * draw. Read on the gl thread only.
+ */
+struct View {
+  Eigen::Matrix4f vp_matrix = Eigen::Matrix4f::Identity();
+  Eigen::Matrix4f projection_matrix = Eigen::Matrix4f::Identity();
+  Eigen::Vector2i viewport = Eigen::Vector2i::Zero();  // pixels
+  Eigen::Vector3f eye = Eigen::Vector3f::Zero();       // camera, world
+
+  // world size of one pixel at clip space w (view depth, or 1 for ortho)
+  float pixelSize(float clip_w) const {
+    if (viewport.x() <= 0) return 0.0f;
+    return 2.0f * clip_w / (projection_matrix(0, 0) * viewport.x());
+  }
+
+  /**
+   * False only if box (model coordinates) is entirely outside the view
+   * frustum; all eight corners beyond one clip plane.
+   */
+  bool intersects(const Eigen::AlignedBox3f& box,
+                  const Eigen::Matrix4f& model_matrix) const {
+    const Eigen::Matrix4f mvp = vp_matrix * model_matrix;
+
+    int outside[6] = {};  // corners beyond -x, +x, -y, +y, -z, +z
+    for (int c = 0; c < 8; c++) {
+      const Eigen::Vector4f clip =
+          mvp * box.corner(static_cast<Eigen::AlignedBox3f::CornerType>(c))
+                    .homogeneous();
+      for (int k = 0; k < 3; k++) {
+        outside[2 * k] += clip[k] < -clip.w();
+        outside[2 * k + 1] += clip[k] > clip.w();
+      }
+    }
+
+    for (int plane = 0; plane < 6; plane++)
+      if (outside[plane] == 8) return false;
+    return true;
+  }
+};
+
+// box around an affinely transformed box.
+inline Eigen::AlignedBox3f transformBox(const Eigen::AlignedBox3f& box,
+                                        const Eigen::Matrix4f& matrix) {
+  Eigen::AlignedBox3f out;
+  if (box.isEmpty()) return out;
+
+  for (int c = 0; c < 8; c++) {
+    const Eigen::Vector4f corner =
+        matrix *
+        box.corner(static_cast<Eigen::AlignedBox3f::CornerType>(c))
+            .homogeneous();
+    out.extend(corner.head<3>());
+  }
+  return out;
+}
+}  // namespace gl
+}  // namespace seg
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+namespace seg {
+/**
+ * Unbounded lock-free queue, many producers and one consumer.
+ * push() is wait-free, a single atomic exchange. pop() never waits either;
+ * it may report empty while a push is halfway done, that item is then
+ * picked up by a later pop(). (intrusive node queue by D. Vyukov)
+ */
+template <typename T>
+class MpscQueue {
+ public:
+  MpscQueue() : head(&stub), tail(&stub) {}
+  ~MpscQueue() {
+    T discard;
+    while (pop(discard)) {
+    }
+    if (tail != &stub) delete tail;
+  }
+  MpscQueue(const MpscQueue&) = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+
+  // producers ====================================================
+  void push(T value) {
+    Node* node = new Node{std::move(value), {nullptr}};
+    Node* prev = head.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+  }
+
+  // consumer =====================================================
+  bool pop(T& out) {
+    Node* next = tail->next.load(std::memory_order_acquire);
+    if (next == nullptr) return false;
+
+    out = std::move(next->value);
+    if (tail != &stub) delete tail;
+    tail = next;  // next becomes the new stub, its value is moved out
+    return true;
+  }
+
+ private:
+  struct Node {
+    T value;
+    std::atomic<Node*> next;
+  };
+
+  Node stub{T(), {nullptr}};
+  std::atomic<Node*> head;  // producers
+  Node* tail;               // consumer
+
+};  // class MpscQueue
+}  // namespace seg
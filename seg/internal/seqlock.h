@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+namespace seg {
+/**
+ * Latest-wins value of a few words, written from any thread, read without
+ * blocking writers. Writers serialize on the sequence (odd while writing);
+ * a reader retries if a write overlapped its copy.
+ * T is trivially copyable and a multiple of 4 bytes.
+ */
+template <typename T>
+class SeqLock {
+  static_assert(std::is_trivially_copyable<T>::value, "");
+  static_assert(sizeof(T) % sizeof(uint32_t) == 0, "");
+
+ public:
+  void store(const T& value) {
+    uint32_t seq = sequence.load(std::memory_order_relaxed);
+    while ((seq & 1) != 0 ||
+           sequence.compare_exchange_weak(seq, seq + 1,
+                                          std::memory_order_acquire) == false) {
+      std::this_thread::yield();
+      seq = sequence.load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    uint32_t src[WORDS];
+    std::memcpy(src, &value, sizeof(T));
+    for (size_t i = 0; i < WORDS; i++)
+      words[i].store(src[i], std::memory_order_relaxed);
+
+    sequence.store(seq + 2, std::memory_order_release);
+  }
+
+  T load() const {
+    uint32_t dst[WORDS];
+    while (true) {
+      const uint32_t before = sequence.load(std::memory_order_acquire);
+      if ((before & 1) != 0) {
+        std::this_thread::yield();
+        continue;
+      }
+
+      for (size_t i = 0; i < WORDS; i++)
+        dst[i] = words[i].load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+
+      if (sequence.load(std::memory_order_relaxed) == before) break;
+    }
+
+    T value;
+    std::memcpy(&value, dst, sizeof(T));
+    return value;
+  }
+
+  // changes with every store(), 0 before the first one.
+  uint32_t version() const { return sequence.load(std::memory_order_acquire); }
+
+ private:
+  static const size_t WORDS = sizeof(T) / sizeof(uint32_t);
+
+  std::atomic<uint32_t> sequence{0};
+  std::atomic<uint32_t> words[WORDS] = {};
+
+};  // class SeqLock
+}  // namespace seg
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "seg/types.h"  // seg::ObjectHandle
+
+namespace seg {
+/**
+ * Values addressed by generational handles, stored densely.
+ * Lookup is two array reads, iteration walks one contiguous vector and
+ * erase moves the last value into the hole, so iteration order is not
+ * insertion order.
+ *
+ * insert(value) allocates a handle. insert(handle, value) places a value at
+ * a handle allocated elsewhere, for a replica of another SlotMap; one map
+ * uses either form, never both.
+ */
+template <typename T>
+class SlotMap {
+ public:
+  ObjectHandle insert(T value) {
+    uint32_t index;
+    if (free_slots.empty()) {
+      index = static_cast<uint32_t>(slots.size());
+      slots.emplace_back();
+    } else {
+      index = free_slots.back();
+      free_slots.pop_back();
+    }
+
+    Slot& slot = slots[index];
+    slot.generation = (slot.generation + 1 == 0) ? 1 : slot.generation + 1;
+
+    const ObjectHandle handle{index, slot.generation};
+    place(handle, std::move(value));
+    return handle;
+  }
+
+  void insert(ObjectHandle handle, T value) {
+    if (slots.size() <= handle.index) slots.resize(handle.index + 1);
+    erase(ObjectHandle{handle.index, slots[handle.index].generation});
+    free_slots.clear();  // a replica never allocates
+
+    slots[handle.index].generation = handle.generation;
+    place(handle, std::move(value));
+  }
+
+  bool erase(ObjectHandle handle) {
+    if (find(handle) == nullptr) return false;
+
+    // last value fills the hole
+    Slot& slot = slots[handle.index];
+    const uint32_t last = static_cast<uint32_t>(values.size() - 1);
+    if (slot.dense != last) {
+      values[slot.dense] = std::move(values[last]);
+      handles[slot.dense] = handles[last];
+      slots[handles[slot.dense].index].dense = slot.dense;
+    }
+    values.pop_back();
+    handles.pop_back();
+
+    slot.dense = NONE;
+    free_slots.push_back(handle.index);
+    return true;
+  }
+
+  void clear() {
+    for (const auto& handle : handles) {
+      slots[handle.index].dense = NONE;
+      free_slots.push_back(handle.index);
+    }
+    values.clear();
+    handles.clear();
+  }
+
+  T* find(ObjectHandle handle) {
+    if (handle.index >= slots.size()) return nullptr;
+
+    const Slot& slot = slots[handle.index];
+    if (slot.generation != handle.generation || slot.dense == NONE)
+      return nullptr;
+    return &values[slot.dense];
+  }
+
+  // dense access, 0 <= i < size()
+  size_t size() const { return values.size(); }
+  T& at(size_t i) { return values[i]; }
+  const ObjectHandle& handleAt(size_t i) const { return handles[i]; }
+
+  typename std::vector<T>::iterator begin() { return values.begin(); }
+  typename std::vector<T>::iterator end() { return values.end(); }
+
+ private:
+  static const uint32_t NONE = UINT32_MAX;
+
+  struct Slot {
+    uint32_t generation = 0;
+    uint32_t dense = NONE;  // index into values, NONE when free
+  };
+
+  void place(ObjectHandle handle, T value) {
+    slots[handle.index].dense = static_cast<uint32_t>(values.size());
+    values.push_back(std::move(value));
+    handles.push_back(handle);
+  }
+
+  std::vector<Slot> slots;
+  std::vector<uint32_t> free_slots;
+  std::vector<T> values;              // dense
+  std::vector<ObjectHandle> handles;  // of values
+
+};  // class SlotMap
+}  // namespace seg
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+
+namespace seg {
+/**
+ * Lock-free latest-wins mailbox between one producer and one consumer.
+ * Neither side ever waits on the other; each owns one slot, the third is
+ * exchanged atomically. Several producers must serialize among themselves.
+ *
+ * Producer : fill back(), publish(). reclaim() takes back a published slot
+ *            the consumer has not picked up yet, so it can be merged into.
+ * Consumer : consume() returns the newest published slot, or nullptr.
+ */
+template <typename T>
+class TripleBuffer {
+ public:
+  TripleBuffer() = default;
+  TripleBuffer(const TripleBuffer&) = delete;
+  TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+  // producer =====================================================
+  T& back() { return slots[back_index]; }
+
+  void publish() {
+    const int prev = middle.exchange(back_index | FRESH);
+    back_index = prev & INDEX_MASK;
+  }
+
+  /**
+   * @return true if back() now holds the unconsumed slot of the last
+   *         publish(), false if it holds a stale slot to be reset.
+   */
+  bool reclaim() {
+    // a non-fresh middle is ignored by the consumer.
+    const int prev = middle.exchange(back_index);
+    back_index = prev & INDEX_MASK;
+    return (prev & FRESH) != 0;
+  }
+
+  // consumer =====================================================
+  T* consume() {
+    if ((middle.load() & FRESH) == 0) return nullptr;
+
+    const int prev = middle.exchange(front_index);
+    front_index = prev & INDEX_MASK;
+    return (prev & FRESH) ? &slots[front_index] : nullptr;
+  }
+
+ private:
+  static const int INDEX_MASK = 0x3;
+  static const int FRESH = 0x4;
+
+  T slots[3];
+  int back_index = 0;  // producer owned
+  std::atomic<int> middle{1};
+  int front_index = 2;  // consumer owned
+
+};  // class TripleBuffer
+}  // namespace seg
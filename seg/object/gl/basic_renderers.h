@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
 #include <tuple>
@@ -7,6 +9,7 @@
 
 #include <Eigen/Dense>
 
+#include "seg/attribute_view.h"
 #include "seg/object/gl_object.h"
 #include "seg/types.h"
 
@@ -18,12 +21,20 @@ class LineRenderer : public GLObject {
   LineRenderer();
 
   const std::string getType() const override { return "Line"; }
+  uint64_t glSortKey() override;
 
   void setColor(const RGBA& _color) { color = _color; }
 
   void addData(const Eigen::Vector3f& vertex);
   void setData(std::vector<Eigen::Vector3f>&& vertices);
   void setData(const std::vector<Eigen::Vector3f>& vertices);
+  // on_release given -> memory is borrowed until it is called.
+  void setData(const AttributeView& vertices,
+               std::function<void()> on_release = nullptr);
+  // overwrites existing vertices, uploading only the touched ranges.
+  void updateData(size_t first, const std::vector<Eigen::Vector3f>& vertices);
+  void updateData(const std::vector<size_t>& indices,
+                  const std::vector<Eigen::Vector3f>& vertices);
 
   void setLineWidth(float _line_width) { line_width = _line_width; }
   float getLineWidth() const { return line_width; }
@@ -33,8 +44,6 @@ class LineRenderer : public GLObject {
 
   RGBA color = RGBA(0.0f, 0.0f, 0.0f, 1.0f);
   float line_width = 1.0f;
-
-  std::vector<Eigen::Vector3f> vertices;
 };  // class LineRenderer
 
 class StaticLineRenderer : public GLObject {
@@ -49,9 +58,15 @@ class StaticLineRenderer : public GLObject {
   void setColor(const RGBA& _color) { color = _color; }
 
   const std::string getType() const override { return "Static Line"; }
+  uint64_t glSortKey() override;
+
+  bool glInstance(Instance& instance) override;
+  void glDrawInstances(const gl::StreamBuffer& instances,
+                       size_t count) override;
 
  private:
   void drawImpl() override;
+  void bindState(const Eigen::Matrix4f& matrix, bool instanced);
 
   RGBA color = RGBA(0.0f, 0.0f, 0.0f, 1.0f);
   float line_width = 1.0f;
@@ -63,36 +78,58 @@ class PointcloudRenderer : public GLObject {
   PointcloudRenderer();
 
   const std::string getType() const override { return "Pointcloud"; }
+  uint64_t glSortKey() override;
   void setColor(const RGBA& _color) { color = _color; }
 
   void addData(const Eigen::Vector3f& vertex);
   void setData(std::vector<Eigen::Vector3f>&& vertices);
   void setData(const std::vector<Eigen::Vector3f>& vertices);
+  // on_release given -> memory is borrowed until it is called.
+  void setData(const AttributeView& vertices,
+               std::function<void()> on_release = nullptr);
 
  private:
   void drawImpl() override;
 
   RGBA color = RGBA(0.0f, 0.0f, 0.0f, 1.0f);
   float point_size = 2.0f;
-
-  std::vector<Eigen::Vector3f> vertices;
 };  // class PoincloudRenderer
 
 class StaticPointcloudRenderer : public GLObject {
  public:
+  /**
+   * @param format - VertexFormat::COMPACT16 / COMPACT8 store the cloud in
+   *                 8 - 12 B per point instead of 28 B. (see seg/types.h)
+   */
   StaticPointcloudRenderer(const std::vector<Eigen::Vector3f>& vertices,
-                           const std::vector<float>& scalars);
+                           const std::vector<float>& scalars,
+                           VertexFormat format = VertexFormat::FLOAT);
   StaticPointcloudRenderer(
       const std::tuple<std::vector<Eigen::Vector3f>,
-                       std::vector<Eigen::Vector3f>>& vertices_colors);
+                       std::vector<Eigen::Vector3f>>& vertices_colors,
+      VertexFormat format = VertexFormat::FLOAT);
   StaticPointcloudRenderer(
       const std::vector<Eigen::Vector3f>& vertices,
       const std::vector<Eigen::Vector3f>& colors =
           std::vector<Eigen::Vector3f>(),
-      const std::vector<float>& scalars = std::vector<float>());
+      const std::vector<float>& scalars = std::vector<float>(),
+      VertexFormat format = VertexFormat::FLOAT);
+
+  /**
+   * @brief From strided float / double views, e.g. pcl style point structs
+   *        or Eigen::Matrix3Xd, converted while packing without copies.
+   * @param on_release - given: the views' memory is borrowed until it is
+   *                     called, packed straight into gpu storage.
+   */
+  StaticPointcloudRenderer(const AttributeView& vertices,
+                           const AttributeView& colors = AttributeView(),
+                           const AttributeView& scalars = AttributeView(),
+                           VertexFormat format = VertexFormat::FLOAT,
+                           std::function<void()> on_release = nullptr);
   void setColor(const RGBA& _color) { color = _color; }
 
   const std::string getType() const override { return "Static Pointcloud"; }
+  uint64_t glSortKey() override;
 
  private:
   void drawImpl() override;
@@ -121,8 +158,13 @@ class StaticMeshRenderer : public GLObject {
   void setColor(const RGBA& _color) { color = _color; }
   const std::string getType() const override { return "Static Mesh"; }
 
+  bool glInstance(Instance& instance) override;
+  void glDrawInstances(const gl::StreamBuffer& instances,
+                       size_t count) override;
+
  private:
   void drawImpl() override;
+  void bindState(const Eigen::Matrix4f& matrix, bool instanced);
 
   RGBA color = RGBA(0.0f, 0.8f, 0.8f, 1.0f);
 
@@ -9,6 +9,7 @@
 #include <imgui.h>
 
 #include "seg/gl/general_renderer.h"
+#include "seg/gl/render_state.h"
 #include "seg/gl/shader.h"
 #include "seg/object/gl/basic_renderers.h"
 #include "seg/ui/general_inspector.h"
@@ -18,9 +19,10 @@ namespace seg {
 namespace object {
 
 LineRenderer::LineRenderer() {
-  pimpl.reset(
-      new gl::GeneralRenderer(gl::GeneralRenderer::BufferType::DYNAMIC,
-                              gl::GeneralRenderer::RenderTarget::LINE_STRIP));
+  pimpl.reset(new gl::Renderer<gl::layout::Position>(
+      gl::GeneralRenderer::BufferType::DYNAMIC,
+      gl::GeneralRenderer::RenderTarget::LINE_STRIP));
+  pimpl->setLatency(&latency);
 
   static int color_edit_flag = 0;
   color_edit_flag |= ImGuiColorEditFlags_NoAlpha;
@@ -42,37 +44,48 @@ LineRenderer::LineRenderer() {
 }
 
 void LineRenderer::addData(const Eigen::Vector3f& vertex) {
-  vertices.push_back(vertex);
+  pimpl->addData(vertex);
+}
 
-  auto copy = vertices;
-  pimpl->setData(std::move(copy));
+void LineRenderer::setData(std::vector<Eigen::Vector3f>&& vertices) {
+  pimpl->setData(std::move(vertices));
 }
 
-void LineRenderer::setData(std::vector<Eigen::Vector3f>&& _vertices) {
-  vertices = std::move(_vertices);
-  auto copy = vertices;
+void LineRenderer::setData(const std::vector<Eigen::Vector3f>& vertices) {
+  setData(AttributeView(vertices));
+}
 
-  pimpl->setData(std::move(copy));
+void LineRenderer::setData(const AttributeView& vertices,
+                            std::function<void()> on_release) {
+  pimpl->setData(vertices, AttributeView(), AttributeView(),
+                 std::vector<Triangle>(), std::move(on_release));
 }
 
-void LineRenderer::setData(const std::vector<Eigen::Vector3f>& _vertices) {
-  vertices = _vertices;
-  auto copy = _vertices;
+void LineRenderer::updateData(size_t first,
+                              const std::vector<Eigen::Vector3f>& vertices) {
+  pimpl->updateData(first, vertices);
+}
+
+void LineRenderer::updateData(const std::vector<size_t>& indices,
+                              const std::vector<Eigen::Vector3f>& vertices) {
+  pimpl->updateData(indices, vertices);
+}
 
-  pimpl->setData(std::move(copy));
+uint64_t LineRenderer::glSortKey() {
+  return sortKeyOf(pimpl.get(), gl::ShaderVariant(ColorMode::UNIFORM), color,
+                   line_width);
 }
 
 void LineRenderer::drawImpl() {
-  glEnable(GL_DEPTH_TEST);
-  glDepthFunc(GL_LESS);
+  gl::RenderState& state = gl::RenderState::getInstance();
+  state.setDepthTest(true, GL_LESS);
 
-  shader->bind();
+  shader->bind(gl::ShaderVariant(ColorMode::UNIFORM));
   shader->setModelMatrix(model_matrix);
-  shader->setColorMode(ColorMode::UNIFORM);
-  shader->setUniform("uniform_color", color.asEigenVector4f());
+  shader->setUniform(gl::Uniform::UNIFORM_COLOR, color.asEigenVector4f());
 
-  glLineWidth(line_width);
-  pimpl->draw(shader);
+  state.setLineWidth(line_width);
+  pimpl->draw();
 }
 
 }  // namespace object
@@ -9,6 +9,7 @@
 #include <imgui.h>
 
 #include "seg/gl/general_renderer.h"
+#include "seg/gl/render_state.h"
 #include "seg/gl/shader.h"
 #include "seg/object/gl/basic_renderers.h"
 #include "seg/ui/general_inspector.h"
@@ -17,9 +18,10 @@
 namespace seg {
 namespace object {
 PointcloudRenderer::PointcloudRenderer() {
-  pimpl.reset(
-      new gl::GeneralRenderer(gl::GeneralRenderer::BufferType::DYNAMIC,
-                              gl::GeneralRenderer::RenderTarget::POINT));
+  pimpl.reset(new gl::Renderer<gl::layout::Position>(
+      gl::GeneralRenderer::BufferType::DYNAMIC,
+      gl::GeneralRenderer::RenderTarget::POINT));
+  pimpl->setLatency(&latency);
 
   static int color_edit_flag = 0;
   color_edit_flag |= ImGuiColorEditFlags_NoAlpha;
@@ -41,38 +43,38 @@ PointcloudRenderer::PointcloudRenderer() {
 }
 
 void PointcloudRenderer::addData(const Eigen::Vector3f& vertex) {
-  vertices.push_back(vertex);
-
-  auto copy = vertices;
-  pimpl->setData(std::move(copy));
+  pimpl->addData(vertex);
 }
 
-void PointcloudRenderer::setData(std::vector<Eigen::Vector3f>&& _vertices) {
-  vertices = std::move(_vertices);
-  auto copy = vertices;
+void PointcloudRenderer::setData(std::vector<Eigen::Vector3f>&& vertices) {
+  pimpl->setData(std::move(vertices));
+}
 
-  pimpl->setData(std::move(copy));
+void PointcloudRenderer::setData(const std::vector<Eigen::Vector3f>& vertices) {
+  setData(AttributeView(vertices));
 }
 
-void PointcloudRenderer::setData(
-    const std::vector<Eigen::Vector3f>& _vertices) {
-  vertices = _vertices;
-  auto copy = _vertices;
+void PointcloudRenderer::setData(const AttributeView& vertices,
+                                  std::function<void()> on_release) {
+  pimpl->setData(vertices, AttributeView(), AttributeView(),
+                 std::vector<Triangle>(), std::move(on_release));
+}
 
-  pimpl->setData(std::move(copy));
+uint64_t PointcloudRenderer::glSortKey() {
+  return sortKeyOf(pimpl.get(), gl::ShaderVariant(ColorMode::UNIFORM), color,
+                   point_size);
 }
 
 void PointcloudRenderer::drawImpl() {
-  glEnable(GL_DEPTH_TEST);
-  glDepthFunc(GL_LESS);
+  gl::RenderState& state = gl::RenderState::getInstance();
+  state.setDepthTest(true, GL_LESS);
 
-  shader->bind();
+  shader->bind(gl::ShaderVariant(ColorMode::UNIFORM));
   shader->setModelMatrix(model_matrix);
-  shader->setColorMode(ColorMode::UNIFORM);
-  shader->setUniform("uniform_color", color.asEigenVector4f());
+  shader->setUniform(gl::Uniform::UNIFORM_COLOR, color.asEigenVector4f());
 
-  glPointSize(point_size);
-  pimpl->draw(shader);
+  state.setPointSize(point_size);
+  pimpl->draw();
 }
 
 }  // namespace object
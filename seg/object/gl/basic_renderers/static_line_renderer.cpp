@@ -1,3 +1,4 @@
+#include <cstring>
 #include <memory>
 #include <stdexcept>
 #include <tuple>
@@ -9,6 +10,8 @@
 #include <imgui.h>
 
 #include "seg/gl/general_renderer.h"
+#include "seg/gl/geometry_cache.h"
+#include "seg/gl/render_state.h"
 #include "seg/gl/shader.h"
 #include "seg/object/gl/basic_renderers.h"
 #include "seg/ui/general_inspector.h"
@@ -27,12 +30,18 @@ StaticLineRenderer::StaticLineRenderer(
   if (vertices.empty())
     throw std::invalid_argument("StaticLineRenderer - Given Vertices empty.");
 
-  pimpl.reset(new gl::GeneralRenderer(gl::GeneralRenderer::BufferType::STATIC,
-                                      gl::GeneralRenderer::RenderTarget::LINE));
+  pimpl = gl::GeometryCache::getInstance().acquire(
+      gl::GeneralRenderer::RenderTarget::LINE, vertices, colors);
+  shared_geometry = pimpl != nullptr;
+  if (shared_geometry == false) {
+    pimpl = gl::GeneralRenderer::create(
+        gl::GeneralRenderer::BufferType::STATIC,
+        gl::GeneralRenderer::RenderTarget::LINE,
+        colors.size() == vertices.size(), false);
 
-  std::vector<Eigen::Vector3f> tmp_vertices = vertices;  // clone
-  std::vector<Eigen::Vector3f> tmp_colors = colors;      // clone
-  pimpl->setData(std::move(tmp_vertices), std::move(tmp_colors));
+    pimpl->setData(AttributeView(vertices), AttributeView(colors),
+                   AttributeView());
+  }
 
   inspector =
       ui::GeneralInspector::Builder()
@@ -43,17 +52,45 @@ StaticLineRenderer::StaticLineRenderer(
           .build();
 }
 
+bool StaticLineRenderer::glInstance(Instance& instance) {
+  if (shared_geometry == false) return false;
+
+  instance.geometry = pimpl.get();
+  std::memcpy(&instance.state, &line_width, sizeof(line_width));
+  instance.transform = model_matrix;
+  instance.color = color;
+  return true;
+}
+
+void StaticLineRenderer::glDrawInstances(const gl::StreamBuffer& instances,
+                                         size_t count) {
+  bindState(Eigen::Matrix4f::Identity(), true);
+  pimpl->drawInstanced(instances, count);
+}
+
+uint64_t StaticLineRenderer::glSortKey() {
+  return sortKeyOf(pimpl.get(), gl::ShaderVariant(ColorMode::UNIFORM), color,
+                   line_width);
+}
+
 void StaticLineRenderer::drawImpl() {
-  glEnable(GL_DEPTH_TEST);
-  glDepthFunc(GL_LESS);
+  bindState(model_matrix, false);
+  shader->setUniform(gl::Uniform::UNIFORM_COLOR, color.asEigenVector4f());
+
+  pimpl->draw();
+}
+
+void StaticLineRenderer::bindState(const Eigen::Matrix4f& matrix,
+                                  bool instanced) {
+  gl::RenderState& state = gl::RenderState::getInstance();
+  state.setDepthTest(true, GL_LESS);
 
-  shader->bind();
-  shader->setUniform("model_matrix", model_matrix);
-  shader->setUniform("color_mode", 0);
-  shader->setUniform("uniform_color", color.asEigenVector4f());
+  shader->bind(gl::ShaderVariant(
+      ColorMode::UNIFORM,
+      instanced ? gl::SHADER_INSTANCED | gl::SHADER_INSTANCE_COLOR : 0));
+  shader->setModelMatrix(matrix);
 
-  glLineWidth(line_width);
-  pimpl->draw(shader);
+  state.setLineWidth(line_width);
 }
 
 }  // namespace object
@@ -8,6 +8,8 @@
 #include <GLFW/glfw3.h>
 
 #include "seg/gl/general_renderer.h"
+#include "seg/gl/geometry_cache.h"
+#include "seg/gl/render_state.h"
 #include "seg/gl/shader.h"
 #include "seg/object/gl/basic_renderers.h"
 #include "seg/ui/general_inspector.h"
@@ -21,27 +23,54 @@ StaticMeshRenderer::StaticMeshRenderer(
   if (std::get<0>(vertices_triangles).empty())
     throw std::invalid_argument("StaticMeshRenderer - Given Vertices empty.");
 
-  pimpl.reset(
-      new gl::GeneralRenderer(gl::GeneralRenderer::BufferType::STATIC,
-                              gl::GeneralRenderer::RenderTarget::TRIANGLES));
+  pimpl = gl::GeometryCache::getInstance().acquire(
+      gl::GeneralRenderer::RenderTarget::TRIANGLES,
+      std::get<0>(vertices_triangles), std::vector<Eigen::Vector3f>(),
+      std::get<1>(vertices_triangles));
+  shared_geometry = pimpl != nullptr;
+  if (shared_geometry) return;
+
+  pimpl.reset(new gl::Renderer<gl::layout::Position>(
+      gl::GeneralRenderer::BufferType::STATIC,
+      gl::GeneralRenderer::RenderTarget::TRIANGLES));
 
-  std::vector<Eigen::Vector3f> tmp_vertices =
-      std::get<0>(vertices_triangles);  // clone
   std::vector<Triangle> tmp_indicies =
       std::get<1>(vertices_triangles);  // clone
-  pimpl->setData(std::move(tmp_vertices), std::move(tmp_indicies));
+  pimpl->setData(AttributeView(std::get<0>(vertices_triangles)),
+                 AttributeView(), AttributeView(), std::move(tmp_indicies));
+}
+
+bool StaticMeshRenderer::glInstance(Instance& instance) {
+  if (shared_geometry == false) return false;
+
+  instance.geometry = pimpl.get();
+  instance.transform = model_matrix;
+  instance.color = color;
+  return true;
+}
+
+void StaticMeshRenderer::glDrawInstances(const gl::StreamBuffer& instances,
+                                         size_t count) {
+  bindState(Eigen::Matrix4f::Identity(), true);
+  pimpl->drawInstanced(instances, count);
 }
 
 void StaticMeshRenderer::drawImpl() {
-  glEnable(GL_DEPTH_TEST);
-  glDepthFunc(GL_LESS);
+  bindState(model_matrix, false);
+  shader->setUniform(gl::Uniform::UNIFORM_COLOR, color.asEigenVector4f());
+
+  pimpl->draw();
+}
 
-  shader->bind();
-  shader->setUniform("model_matrix", model_matrix);
-  shader->setUniform("color_mode", 0);
-  shader->setUniform("uniform_color", color.asEigenVector4f());
+void StaticMeshRenderer::bindState(const Eigen::Matrix4f& matrix,
+                                  bool instanced) {
+  gl::RenderState& state = gl::RenderState::getInstance();
+  state.setDepthTest(true, GL_LESS);
 
-  pimpl->draw(shader);
+  shader->bind(gl::ShaderVariant(
+      ColorMode::UNIFORM,
+      instanced ? gl::SHADER_INSTANCED | gl::SHADER_INSTANCE_COLOR : 0));
+  shader->setModelMatrix(matrix);
 }
 
 }  // namespace object
@@ -1,3 +1,4 @@
+#include <functional>
 #include <memory>
 #include <stdexcept>
 #include <tuple>
@@ -9,6 +10,7 @@
 #include <imgui.h>
 
 #include "seg/gl/general_renderer.h"
+#include "seg/gl/render_state.h"
 #include "seg/gl/shader.h"
 #include "seg/object/gl/basic_renderers.h"
 #include "seg/ui/general_inspector.h"
@@ -19,34 +21,47 @@ namespace object {
 
 StaticPointcloudRenderer::StaticPointcloudRenderer(
     const std::vector<Eigen::Vector3f>& vertices,
-    const std::vector<float>& scalars)
+    const std::vector<float>& scalars,
+    VertexFormat format)
     : StaticPointcloudRenderer(
-          vertices, std::vector<Eigen::Vector3f>(), scalars) {}
+          vertices, std::vector<Eigen::Vector3f>(), scalars, format) {}
 
 StaticPointcloudRenderer::StaticPointcloudRenderer(
     const std::tuple<std::vector<Eigen::Vector3f>,
-                     std::vector<Eigen::Vector3f>>& vertices_colors)
+                     std::vector<Eigen::Vector3f>>& vertices_colors,
+    VertexFormat format)
     : StaticPointcloudRenderer(std::get<0>(vertices_colors),
-                               std::get<1>(vertices_colors)) {}
+                               std::get<1>(vertices_colors),
+                               std::vector<float>(),
+                               format) {}
 
 StaticPointcloudRenderer::StaticPointcloudRenderer(
     const std::vector<Eigen::Vector3f>& vertices,
     const std::vector<Eigen::Vector3f>& colors,
-    const std::vector<float>& scalars) {
+    const std::vector<float>& scalars,
+    VertexFormat format)
+    : StaticPointcloudRenderer(AttributeView(vertices),
+                               AttributeView(colors),
+                               AttributeView(scalars),
+                               format) {}
+
+StaticPointcloudRenderer::StaticPointcloudRenderer(
+    const AttributeView& vertices,
+    const AttributeView& colors,
+    const AttributeView& scalars,
+    VertexFormat format,
+    std::function<void()> on_release) {
   if (vertices.empty())
     throw std::invalid_argument(
         "StaticPointcloudRenderer - Given Vertices empty.");
 
-  pimpl.reset(
-      new gl::GeneralRenderer(gl::GeneralRenderer::BufferType::STATIC,
-                              gl::GeneralRenderer::RenderTarget::POINT));
+  pimpl = gl::GeneralRenderer::create(
+      gl::GeneralRenderer::BufferType::STATIC,
+      gl::GeneralRenderer::RenderTarget::POINT,
+      colors.count == vertices.count, scalars.count == vertices.count, format);
 
-  // clone
-  std::vector<Eigen::Vector3f> tmp_vertices = vertices;
-  std::vector<Eigen::Vector3f> tmp_colors = colors;
-  std::vector<float> tmp_scalars = scalars;
-  pimpl->setData(std::move(tmp_vertices), std::move(tmp_colors),
-                 std::move(tmp_scalars));
+  pimpl->setData(vertices, colors, scalars, std::vector<Triangle>(),
+                 std::move(on_release));
 
   inspector = ui::GeneralInspector::Builder()
                   .addField("Vertices", &pimpl->vertexCount())
@@ -56,32 +71,39 @@ StaticPointcloudRenderer::StaticPointcloudRenderer(
                   .build();
 }
 
+uint64_t StaticPointcloudRenderer::glSortKey() {
+  return sortKeyOf(pimpl.get(), gl::ShaderVariant(color_mode), color,
+                   point_size);
+}
+
 void StaticPointcloudRenderer::drawImpl() {
-  glEnable(GL_DEPTH_TEST);
-  glDepthFunc(GL_LESS);
+  gl::RenderState& state = gl::RenderState::getInstance();
+  state.setDepthTest(true, GL_LESS);
 
-  shader->bind();
+  shader->bind(gl::ShaderVariant(color_mode));
   shader->setModelMatrix(model_matrix);
-  shader->setColorMode(color_mode);
-  shader->setUniform("uniform_color", color.asEigenVector4f());
+  shader->setUniform(gl::Uniform::UNIFORM_COLOR, color.asEigenVector4f());
 
   switch (color_mode) {
     case ColorMode::ZAXIS:
-      shader->setUniform("visualize_z_min", visualize_z_min);
-      shader->setUniform("visualize_z_max", visualize_z_max);
+      shader->setUniform(gl::Uniform::VISUALIZE_Z_MIN, visualize_z_min);
+      shader->setUniform(gl::Uniform::VISUALIZE_Z_MAX, visualize_z_max);
       [[fallthrough]];
     case ColorMode::SCALAR:
-      shader->setUniform("visualize_hue_from", visualize_hue_from);
-      shader->setUniform("visualize_hue_to", visualize_hue_to);
-      shader->setUniform("visualize_saturation", visualize_saturation);
-      shader->setUniform("visualize_value", visualize_value);
+      shader->setUniform(gl::Uniform::VISUALIZE_HUE_FROM, visualize_hue_from);
+      shader->setUniform(gl::Uniform::VISUALIZE_HUE_TO, visualize_hue_to);
+      shader->setUniform(gl::Uniform::VISUALIZE_SATURATION,
+                         visualize_saturation);
+      shader->setUniform(gl::Uniform::VISUALIZE_VALUE, visualize_value);
       break;
     default:
       break;
   }
 
-  glPointSize(point_size);
-  pimpl->draw(shader);
+  state.setPointSize(point_size);
+  pimpl->draw([this](const gl::GeneralRenderer::Chunk& chunk) {
+    shader->setModelMatrix(model_matrix * chunk.dequantize());
+  });
 }
 
 void StaticPointcloudRenderer::drawInspector() {
@@ -91,6 +113,11 @@ void StaticPointcloudRenderer::drawInspector() {
   color_edit_flag |= ImGuiColorEditFlags_PickerHueBar;
   color_edit_flag |= ImGuiColorEditFlags_DisplayRGB;
 
+  const float resident_mb = pimpl->residentBytes() / (1024.0f * 1024.0f);
+  const float float_mb = pimpl->floatBytes() / (1024.0f * 1024.0f);
+  ImGui::Text("VRAM %.1f MB (saved %.1f MB)", resident_mb,
+              float_mb - resident_mb);
+
   ImGui::SliderFloat("Point Size", &point_size, 1.0, 5.0, "%.1f");
 
   // Color mode selection
@@ -0,0 +1,123 @@
+#include "seg/object/gl/octree_pointcloud.h"
+
+#include <memory>
+
+#include <GL/glew.h>
+#include <imgui.h>
+
+#include "seg/gl/point_octree.h"
+#include "seg/gl/render_state.h"
+#include "seg/gl/shader.h"
+#include "seg/ui/general_inspector.h"
+#include "seg/internal/logger.h"
+
+namespace seg {
+namespace object {
+OctreePointcloud::OctreePointcloud(const AttributeView& vertices,
+                                   const AttributeView& colors,
+                                   const AttributeView& scalars,
+                                   VertexFormat format) {
+  octree.reset(new gl::PointOctree(vertices, colors, scalars, format));
+  if (octree->hasColor()) color_mode = ColorMode::RGB;
+
+  inspector = ui::GeneralInspector::Builder()
+                  .addField("Points", &octree->pointCount())
+                  .addField("Nodes", &octree->nodeCount())
+                  .addDrawFunction([this] { drawInspector(); })
+                  .build();
+}
+
+// complete gl types for the unique_ptr.
+OctreePointcloud::~OctreePointcloud() {}
+
+void OctreePointcloud::glFree() { octree->glFree(); }
+
+void OctreePointcloud::setPointBudget(size_t points) {
+  octree->point_budget = points;
+}
+
+void OctreePointcloud::setMaxResidentPoints(size_t points) {
+  octree->max_resident_points = points;
+}
+
+Eigen::AlignedBox3f OctreePointcloud::glBounds() {
+  return octree->glBounds();
+}
+
+void OctreePointcloud::drawImpl() {
+  if (view == nullptr) return;  // node selection needs the camera
+
+  gl::RenderState& state = gl::RenderState::getInstance();
+  state.setDepthTest(true, GL_LESS);
+
+  shader->bind(gl::ShaderVariant(color_mode));
+  shader->setModelMatrix(model_matrix);
+  shader->setUniform(gl::Uniform::UNIFORM_COLOR, color.asEigenVector4f());
+  if (color_mode == ColorMode::ZAXIS) {
+    shader->setUniform(gl::Uniform::VISUALIZE_Z_MIN, visualize_z_min);
+    shader->setUniform(gl::Uniform::VISUALIZE_Z_MAX, visualize_z_max);
+  }
+
+  state.setPointSize(point_size);
+  octree->draw(*view, model_matrix,
+               [this](const gl::GeneralRenderer::Chunk& chunk) {
+                 shader->setModelMatrix(model_matrix * chunk.dequantize());
+               });
+}
+
+void OctreePointcloud::drawInspector() {
+  static int color_edit_flag = 0;
+  color_edit_flag |= ImGuiColorEditFlags_NoAlpha;
+  color_edit_flag |= ImGuiColorEditFlags_NoSidePreview;
+  color_edit_flag |= ImGuiColorEditFlags_PickerHueBar;
+  color_edit_flag |= ImGuiColorEditFlags_DisplayRGB;
+
+  ImGui::Text("Drawn %zu points in %zu nodes", octree->drawnPoints(),
+              octree->drawnNodes());
+  ImGui::Text("Resident %zu points", octree->residentPoints());
+
+  int budget_k = static_cast<int>(octree->point_budget / 1000);
+  if (ImGui::SliderInt("Budget (k)", &budget_k, 100, 30000))
+    octree->point_budget = static_cast<size_t>(budget_k) * 1000;
+
+  ImGui::SliderFloat("Point Size", &point_size, 1.0, 5.0, "%.1f");
+
+  if (ImGui::BeginCombo("Coloring", enumToCharP(color_mode))) {
+    if (ImGui::Selectable(enumToCharP(ColorMode::UNIFORM),
+                          color_mode == ColorMode::UNIFORM))
+      color_mode = ColorMode::UNIFORM;
+
+    if (octree->hasColor()) {
+      if (ImGui::Selectable(enumToCharP(ColorMode::RGB),
+                            color_mode == ColorMode::RGB))
+        color_mode = ColorMode::RGB;
+    }
+
+    if (octree->hasScalar()) {
+      if (ImGui::Selectable(enumToCharP(ColorMode::SCALAR),
+                            color_mode == ColorMode::SCALAR))
+        color_mode = ColorMode::SCALAR;
+    }
+
+    if (ImGui::Selectable(enumToCharP(ColorMode::ZAXIS),
+                          color_mode == ColorMode::ZAXIS))
+      color_mode = ColorMode::ZAXIS;
+
+    ImGui::EndCombo();
+  }
+
+  if (color_mode == ColorMode::UNIFORM) {
+    if (ImGui::TreeNode("Color Picker")) {
+      ImGui::ColorPicker3("##", (float*)&color, color_edit_flag);
+      ImGui::TreePop();
+    }
+  } else if (color_mode == ColorMode::ZAXIS) {
+    ImGui::SliderFloat("Z Min", &visualize_z_min, -30.0f, 0.0f,
+                       "min z = %.2f");
+    ImGui::SliderFloat("Z Max", &visualize_z_max, 0.0f, 200.0f,
+                       "max z = %.2f");
+  }
+}
+
+}  // namespace object
+}  // namespace seg
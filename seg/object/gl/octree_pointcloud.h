@@ -0,0 +1,64 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <Eigen/Dense>
+
+#include "seg/attribute_view.h"
+#include "seg/object/gl_object.h"
+#include "seg/types.h"
+
+namespace seg {
+namespace gl {
+class PointOctree;
+}  // namespace gl
+
+namespace object {
+/**
+ * Large static point cloud drawn at a level of detail, e.g. a whole map of
+ * hundreds of millions of points. An octree is built in the background;
+ * each frame draws the nodes largest on screen up to a point budget, and
+ * nodes stream in and out of gpu memory as the view moves.
+ */
+class OctreePointcloud : public GLObject {
+ public:
+  /**
+   * @brief Copies the points; the views may be released on return.
+   *        Colors / scalars not matching the vertices are ignored.
+   * @throw std::invalid_argument on empty vertices.
+   */
+  OctreePointcloud(const AttributeView& vertices,
+                   const AttributeView& colors = AttributeView(),
+                   const AttributeView& scalars = AttributeView(),
+                   VertexFormat format = VertexFormat::COMPACT16);
+  ~OctreePointcloud() override;
+  const std::string getType() const override { return "Octree Pointcloud"; }
+
+  void glFree() override;
+
+  void setColor(const RGBA& _color) { color = _color; }
+  void setPointSize(float _point_size) { point_size = _point_size; }
+
+  // points drawn per frame
+  void setPointBudget(size_t points);
+  // points kept on the gpu, least recently drawn nodes are freed beyond it.
+  void setMaxResidentPoints(size_t points);
+
+ private:
+  void drawImpl() override;
+  void drawInspector();
+  Eigen::AlignedBox3f glBounds() override;
+
+  ColorMode color_mode = ColorMode::UNIFORM;
+  RGBA color = RGBA(0.0f, 0.0f, 0.0f, 1.0f);
+  float point_size = 2.0f;
+
+  float visualize_z_min = -10.0f;
+  float visualize_z_max = 30.0f;
+
+  std::unique_ptr<gl::PointOctree> octree;
+
+};  // class OctreePointcloud
+}  // namespace object
+}  // namespace seg
@@ -1,13 +1,20 @@
 #include "seg/object/gl/path.h"
 
-#include <iostream>
+#include <algorithm>
+#include <memory>
 #include <mutex>
+#include <stdexcept>
 #include <vector>
 
+#include <GL/glew.h>
 #include <imgui.h>
 
-#include "seg/object/gl/basic_renderers.h"
-#include "seg/object/gl/pose.h"
+#include "seg/gl/general_renderer.h"
+#include "seg/gl/instance_buffer.h"
+#include "seg/gl/line_pyramid.h"
+#include "seg/gl/render_state.h"
+#include "seg/gl/shader.h"
+#include "seg/object/primitives.h"
 #include "seg/ui/general_inspector.h"
 #include "seg/internal/logger.h"
 
@@ -29,25 +36,18 @@ inline bool hasType(object::Path::VisualType type,
 namespace object {
 Path::Path() : Path(std::vector<Eigen::Matrix4f>()) {}
 
-Path::Path(std::vector<Eigen::Matrix4f> _poses) : poses(_poses) {
-  num_pose = _poses.size();
+Path::Path(std::vector<Eigen::Matrix4f> _poses) {
+  line_pyramid.reset(new gl::LinePyramid());
+  instances.reset(new gl::InstanceBuffer());
+  reset(std::move(_poses));
 
-  line_renderer.reset(new LineRenderer());
-  pose_renderer.reset(new Pose());
-  if (poses.size() != 0) {
-    std::vector<Eigen::Vector3f> vertices;
-    vertices.reserve(poses.size());
-
-    for (auto&& mat : poses) vertices.push_back(mat.block<3, 1>(0, 3));
-
-    line_renderer->setData(std::move(vertices));
-  }
-
-  line_renderer->setLineWidth(line_width);
-  line_renderer->setColor(line_color);
-
-  pose_renderer->setLineWidth(axis_frame_line_width);
-  pose_renderer->setColor(frame_color);
+  axis_renderer.reset(new gl::Renderer<gl::layout::PositionColor>(
+      gl::GeneralRenderer::BufferType::STATIC,
+      gl::GeneralRenderer::RenderTarget::LINE));
+  frame_renderer.reset(new gl::Renderer<gl::layout::Position>(
+      gl::GeneralRenderer::BufferType::STATIC,
+      gl::GeneralRenderer::RenderTarget::LINE));
+  frame_vertices = primitives::CameraFrame();
 
   inspector = ui::GeneralInspector::Builder()
                   .addField("Count", &num_pose)
@@ -55,30 +55,35 @@ Path::Path(std::vector<Eigen::Matrix4f> _poses) : poses(_poses) {
                   .build();
 }
 
-void Path::glFree() {
-  line_renderer->glFree();
-  pose_renderer->glFree();
-}
+// complete gl types for the unique_ptrs.
+Path::~Path() {}
 
-void Path::setShader(gl::Shader* _shader) {
-  line_renderer->setShader(_shader);
-  pose_renderer->setShader(_shader);
+void Path::glFree() {
+  line_pyramid->glFree();
+  axis_renderer->glFree();
+  frame_renderer->glFree();
+  instances->glFree();
 }
 
 void Path::setCameraParameters(float width, float height, float focal_length) {
-  pose_renderer->setCameraParameters(width, height, focal_length);
+  std::lock_guard<std::mutex> lock(geometry_mtx);
+  frame_vertices = primitives::CameraFrame(width, height, focal_length);
+  geometry_dirty = true;
 }
 
 void Path::setCameraParameters(
     float width, float height, float fx, float fy, float cx, float cy) {
-  pose_renderer->setCameraParameters(width, height, fx, fy, cx, cy);
+  std::lock_guard<std::mutex> lock(geometry_mtx);
+  frame_vertices = primitives::CameraFrame(width, height, fx, fy, cx, cy);
+  geometry_dirty = true;
 }
 
 void Path::reset() {
   std::lock_guard<std::mutex> lock(pose_mtx);
-  num_pose = 0;
   poses.clear();
-  line_renderer->setData(std::vector<Eigen::Vector3f>());
+  num_pose = 0;
+  line_pyramid->set(std::vector<Eigen::Vector3f>());
+  instances->set(std::vector<CompactPose>());
 }
 
 void Path::reset(const std::vector<Eigen::Matrix4f>& _poses) {
@@ -92,37 +97,148 @@ void Path::reset(std::vector<Eigen::Matrix4f>&& _poses) {
     return;
   }
 
-  std::lock_guard<std::mutex> lock(pose_mtx);
-  num_pose = _poses.size();
-  poses = std::move(_poses);
+  std::vector<CompactPose> compact(_poses.begin(), _poses.end());
   std::vector<Eigen::Vector3f> vertices;
-  vertices.reserve(poses.size());
-  for (auto&& mat : poses) vertices.push_back(mat.block<3, 1>(0, 3));
-  line_renderer->setData(std::move(vertices));
+  vertices.reserve(compact.size());
+  for (auto&& pose : compact) vertices.push_back(pose.position());
+
+  std::lock_guard<std::mutex> lock(pose_mtx);
+  poses = compact;
+  num_pose = poses.size();
+  line_pyramid->set(vertices);
+  instances->set(std::move(compact));
+  latency.stamp();
 }
 
 void Path::addPose(const Eigen::Matrix4f& pose) {
+  const CompactPose compact(pose);
+
   std::lock_guard<std::mutex> lock(pose_mtx);
-  poses.push_back(pose);
+  poses.push_back(compact);
   num_pose++;
-  line_renderer->addData(pose.block<3, 1>(0, 3));
+  line_pyramid->add(compact.position());
+  instances->add(compact);
+  latency.stamp();
 }
 
-void Path::drawImpl() {
+void Path::updatePoses(const std::vector<size_t>& indices,
+                       const std::vector<Eigen::Matrix4f>& _poses) {
+  if (indices.size() != _poses.size()) {
+    LOG_ERROR("Path - updatePoses size mismatch!");
+    throw std::invalid_argument("Indices and poses differ in size!");
+  }
+
+  std::vector<CompactPose> compact(_poses.begin(), _poses.end());
+  std::vector<Eigen::Vector3f> vertices;
+  vertices.reserve(compact.size());
+  for (auto&& pose : compact) vertices.push_back(pose.position());
+
+  std::lock_guard<std::mutex> lock(pose_mtx);
+  for (const size_t index : indices) {
+    if (index >= poses.size()) {
+      LOG_ERROR("Path - Pose index {} out of range!", index);
+      throw std::invalid_argument("Pose index out of range given!");
+    }
+  }
+
+  for (size_t i = 0; i < indices.size(); i++) poses[indices[i]] = compact[i];
+  line_pyramid->update(indices, vertices);
+  instances->update(indices, compact);
+  latency.stamp();
+}
+
+void Path::updatePoseRange(size_t first,
+                           const std::vector<Eigen::Matrix4f>& _poses) {
+  std::vector<CompactPose> compact(_poses.begin(), _poses.end());
+  std::vector<Eigen::Vector3f> vertices;
+  vertices.reserve(compact.size());
+  for (auto&& pose : compact) vertices.push_back(pose.position());
+
   std::lock_guard<std::mutex> lock(pose_mtx);
-  if (hasType(type, VisualType::LINE)) line_renderer->draw();
+  if (first + compact.size() > poses.size()) {
+    LOG_ERROR("Path - Pose range [{}, {}) out of range!", first,
+              first + compact.size());
+    throw std::invalid_argument("Pose range out of range given!");
+  }
+
+  std::copy(compact.begin(), compact.end(), poses.begin() + first);
+  line_pyramid->update(first, vertices);
+  instances->update(first, compact);
+  latency.stamp();
+}
+
+void Path::uploadFrameGeometry() {
+  const float scale = frame_scale;
+
+  auto axis = primitives::Axis(scale);
+  axis_renderer->setData(std::move(std::get<0>(axis)),
+                         std::move(std::get<1>(axis)));
+
+  std::vector<Eigen::Vector3f> frame;
+  {
+    std::lock_guard<std::mutex> lock(geometry_mtx);
+    frame = frame_vertices;
+  }
+  for (auto& vertex : frame) vertex *= scale;
+  frame_renderer->setData(std::move(frame));
+
+  uploaded_scale = scale;
+}
+
+Eigen::AlignedBox3f Path::glBounds() {
+  Eigen::AlignedBox3f box = line_pyramid->glBounds();
+  if (type == VisualType::LINE || box.isEmpty()) return box;
+
+  const Eigen::AlignedBox3f frame = hasType(type, VisualType::AXIS)
+                                        ? axis_renderer->glBounds()
+                                        : frame_renderer->glBounds();
+  if (frame.isEmpty()) return Eigen::AlignedBox3f();  // not set yet
+
+  // a frame reaches at most its radius away from its pose
+  const float radius =
+      frame.min().cwiseAbs().cwiseMax(frame.max().cwiseAbs()).norm();
+  box.min().array() -= radius;
+  box.max().array() += radius;
+  return box;
+}
+
+void Path::drawImpl() {
+  gl::RenderState& state = gl::RenderState::getInstance();
+  state.setDepthTest(true, GL_LESS);
+
+  if (hasType(type, VisualType::LINE)) {
+    // vertex count follows screen resolution, not trajectory length.
+    drawn_level = (use_lod && view)
+                      ? line_pyramid->selectLevel(*view, model_matrix,
+                                                  lod_tolerance)
+                      : 0;
+
+    shader->bind(gl::ShaderVariant(ColorMode::UNIFORM));
+    shader->setModelMatrix(model_matrix);
+    shader->setUniform(gl::Uniform::UNIFORM_COLOR,
+                       line_color.asEigenVector4f());
+    state.setLineWidth(line_width);
+    line_pyramid->draw(drawn_level);
+  }
 
   if (type == VisualType::LINE) return;
 
+  if (geometry_dirty.exchange(false) || uploaded_scale != frame_scale)
+    uploadFrameGeometry();
+
+  state.setLineWidth(axis_frame_line_width);
+
+  // every pose in one draw; cost no longer scales with cpu work per pose.
   if (hasType(type, VisualType::AXIS)) {
-    pose_renderer->setVisualType(Pose::VisualType::AXIS);
+    shader->bind(gl::ShaderVariant(ColorMode::RGB, gl::SHADER_INSTANCED));
+    shader->setModelMatrix(model_matrix);
+    axis_renderer->drawInstanced(*instances);
   } else if (hasType(type, VisualType::CAMERA_FRAMES)) {
-    pose_renderer->setVisualType(Pose::VisualType::CAMERA_FRAME);
-  }
-
-  for (auto&& pose : poses) {
-    pose_renderer->setData(pose);
-    pose_renderer->draw();
+    shader->bind(gl::ShaderVariant(ColorMode::UNIFORM, gl::SHADER_INSTANCED));
+    shader->setModelMatrix(model_matrix);
+    shader->setUniform(gl::Uniform::UNIFORM_COLOR,
+                       frame_color.asEigenVector4f());
+    frame_renderer->drawInstanced(*instances);
   }
 }
 
@@ -162,8 +278,11 @@ void Path::drawInspector() {
       ImGui::SliderFloat("Thickness", &line_width, 0.0, 1.0, "%.2f");
       ImGui::ColorPicker3("##", (float*)&line_color, color_edit_flag);
 
-      line_renderer->setLineWidth(line_width);
-      line_renderer->setColor(line_color);
+      ImGui::Checkbox("LOD", &use_lod);
+      if (use_lod)
+        ImGui::SliderFloat("Tolerance (px)", &lod_tolerance, 0.5, 8.0, "%.1f");
+      ImGui::Text("Level %d, %zu vertices", drawn_level,
+                  line_pyramid->vertexCount(drawn_level));
 
       ImGui::TreePop();
     }
@@ -171,8 +290,8 @@ void Path::drawInspector() {
 
   if (hasType(type, VisualType::AXIS)) {
     if (ImGui::TreeNode("Axis Options")) {
-      ImGui::SliderFloat("Scale", &pose_renderer->scale, 0.1, 5.0, "%.1f");
-      ImGui::SliderFloat("Thickness", &pose_renderer->line_width, 0.0, 1.0,
+      ImGui::SliderFloat("Scale", &frame_scale, 0.1, 5.0, "%.1f");
+      ImGui::SliderFloat("Thickness", &axis_frame_line_width, 0.0, 1.0,
                          "%.2f");
 
       ImGui::TreePop();
@@ -181,14 +300,12 @@ void Path::drawInspector() {
 
   if (hasType(type, VisualType::CAMERA_FRAMES)) {
     if (ImGui::TreeNode("Frame Options")) {
-      ImGui::SliderFloat("Scale", &pose_renderer->scale, 0.1, 5.0, "%.1f");
-      ImGui::SliderFloat("Thickness", &pose_renderer->line_width, 0.0, 1.0,
+      ImGui::SliderFloat("Scale", &frame_scale, 0.1, 5.0, "%.1f");
+      ImGui::SliderFloat("Thickness", &axis_frame_line_width, 0.0, 1.0,
                          "%.2f");
 
       ImGui::ColorPicker3("##", (float*)&frame_color, color_edit_flag);
 
-      pose_renderer->setColor(frame_color);
-
       ImGui::TreePop();
     }
   }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <vector>
 
@@ -11,13 +13,12 @@
 namespace seg {
 namespace gl {
 class Shader;
-}
+class InstanceBuffer;
+class LinePyramid;
+}  // namespace gl
 
 namespace object {
 
-class LineRenderer;
-class Pose;
-
 class Path : public GLObject {
  public:
   enum class VisualType {
@@ -32,10 +33,10 @@ class Path : public GLObject {
  public:
   Path();
   Path(std::vector<Eigen::Matrix4f> poses);
+  ~Path() override;
   const std::string getType() const override { return "Path"; }
 
   void glFree() override;
-  void setShader(gl::Shader* shader) override;
 
   void setCameraParameters(float width, float height, float focal_length);
   void setCameraParameters(
@@ -47,11 +48,22 @@ class Path : public GLObject {
 
   void addPose(const Eigen::Matrix4f& pose);
 
+  /**
+   * @brief Moves existing poses, e.g. after a loop closure. Only the changed
+   *        line vertices and pose frames are uploaded.
+   * @throw std::invalid_argument on size mismatch or indices past the count.
+   */
+  void updatePoses(const std::vector<size_t>& indices,
+                   const std::vector<Eigen::Matrix4f>& poses);
+  void updatePoseRange(size_t first, const std::vector<Eigen::Matrix4f>& poses);
+
   void setVisualType(VisualType _type) { type = _type; }
 
  private:
   void drawImpl() override;
   void drawInspector();
+  void uploadFrameGeometry();
+  Eigen::AlignedBox3f glBounds() override;
 
   VisualType type = VisualType::LINE;
 
@@ -60,13 +72,30 @@ class Path : public GLObject {
 
   float axis_frame_line_width = 1.0f;
   float line_width = 1.0f;
+  float frame_scale = 0.3f;
+
+  // line lod: coarsest level off by at most lod_tolerance pixels.
+  bool use_lod = true;
+  float lod_tolerance = 1.0f;
+  int drawn_level = 0;  // gl thread
 
+  // producer side. the gl thread never locks it.
   std::mutex pose_mtx;
+  std::vector<CompactPose> poses;
   size_t num_pose;
-  std::vector<Eigen::Matrix4f> poses;
 
-  std::unique_ptr<LineRenderer> line_renderer;
-  std::unique_ptr<Pose> pose_renderer;
+  std::unique_ptr<gl::LinePyramid> line_pyramid;
+
+  // one instanced draw for every pose frame, instances are the poses.
+  std::unique_ptr<gl::InstanceBuffer> instances;
+  std::unique_ptr<gl::GeneralRenderer> axis_renderer;
+  std::unique_ptr<gl::GeneralRenderer> frame_renderer;
+
+  // unit frame geometry, uploaded scaled by frame_scale.
+  std::mutex geometry_mtx;
+  std::vector<Eigen::Vector3f> frame_vertices;
+  std::atomic<bool> geometry_dirty{true};
+  float uploaded_scale = 0.0f;  // gl thread
 };  // class Path
 
 }  // namespace object
@@ -1,12 +1,20 @@
 #include "seg/object/gl/pose.h"
 
+#include <cstring>
+#include <memory>
+#include <mutex>
+
 #include <Eigen/Dense>
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include <imgui.h>
 
+#include "seg/core/frame_request.h"
 #include "seg/gl/general_renderer.h"
+#include "seg/gl/geometry_cache.h"
+#include "seg/gl/render_state.h"
 #include "seg/gl/shader.h"
+#include "seg/gl/view.h"
 #include "seg/object/primitives.h"
 #include "seg/ui/general_inspector.h"
 #include "seg/internal/logger.h"
@@ -25,32 +33,47 @@ namespace object {
 Pose::Pose() : Pose(Eigen::Matrix4f::Identity()) {}
 
 Pose::Pose(const Eigen::Matrix4f _pose) : pose(_pose) {
-  pimpl.reset(new gl::GeneralRenderer(gl::GeneralRenderer::BufferType::STATIC,
-                                      gl::GeneralRenderer::RenderTarget::LINE));
-
-  camera_frame = primitives::CameraFrame();
-  axis = primitives::Axis();
-
-  auto copy = axis;
-  pimpl->setData(std::move(std::get<0>(copy)), std::move(std::get<1>(copy)));
+  auto& cache = gl::GeometryCache::getInstance();
+  const auto axis = primitives::Axis();
+  pimpl = cache.acquire(gl::GeneralRenderer::RenderTarget::LINE,
+                        std::get<0>(axis), std::get<1>(axis));
+  frame_renderer = cache.acquire(gl::GeneralRenderer::RenderTarget::LINE,
+                                 primitives::CameraFrame());
+  shared_geometry = true;
 
   inspector = ui::GeneralInspector::Builder()
                   .addDrawFunction([this] { drawInspector(); })
                   .build();
 }
 
+Pose::~Pose() {}
+
 void Pose::setCameraParameters(float width, float height, float focal_length) {
-  camera_frame = primitives::CameraFrame(width, height, focal_length);
+  auto frame = gl::GeometryCache::getInstance().acquire(
+      gl::GeneralRenderer::RenderTarget::LINE,
+      primitives::CameraFrame(width, height, focal_length));
+
+  std::lock_guard<std::mutex> lock(pose_mtx);
+  frame_renderer.swap(frame);
 }
 
 void Pose::setCameraParameters(
     float width, float height, float fx, float fy, float cx, float cy) {
-  camera_frame = primitives::CameraFrame(width, height, fx, fy, cx, cy);
+  auto frame = gl::GeometryCache::getInstance().acquire(
+      gl::GeneralRenderer::RenderTarget::LINE,
+      primitives::CameraFrame(width, height, fx, fy, cx, cy));
+
+  std::lock_guard<std::mutex> lock(pose_mtx);
+  frame_renderer.swap(frame);
 }
 
 void Pose::setData(Eigen::Matrix4f&& _pose) {
-  std::lock_guard<std::mutex> lock(pose_mtx);
-  pose = _pose;
+  {
+    std::lock_guard<std::mutex> lock(pose_mtx);
+    pose = _pose;
+  }
+  latency.stamp();
+  FrameRequest::request();
 }
 
 void Pose::setData(const Eigen::Matrix4f& _pose) {
@@ -88,41 +111,69 @@ void Pose::drawInspector() {
   }
 }
 
-void Pose::drawImpl() {
-  {
-    std::lock_guard<std::mutex> lock(pose_mtx);
-    model_matrix.block<3, 3>(0, 0) = pose.block<3, 3>(0, 0) * scale;
-    model_matrix.block<3, 1>(0, 3) = pose.block<3, 1>(0, 3);
-  }
+Eigen::Matrix4f Pose::poseMatrix() {
+  Eigen::Matrix4f pose_matrix = Eigen::Matrix4f::Identity();
 
-  if (prev != type) {
-    if (type == VisualType::AXIS) {
-      auto copy = axis;
-      pimpl->setData(std::move(std::get<0>(copy)),
-                     std::move(std::get<1>(copy)));
-    } else {
-      auto tmp = camera_frame;
-      pimpl->setData(std::move(tmp));
-    }
+  std::lock_guard<std::mutex> lock(pose_mtx);
+  pose_matrix.block<3, 3>(0, 0) = pose.block<3, 3>(0, 0) * scale;
+  pose_matrix.block<3, 1>(0, 3) = pose.block<3, 1>(0, 3);
+  return pose_matrix;
+}
 
-    prev = type;
-  }
+std::shared_ptr<gl::GeneralRenderer> Pose::geometry() {
+  if (type == VisualType::AXIS) return pimpl;
 
-  glEnable(GL_DEPTH_TEST);
-  glDepthFunc(GL_LESS);
+  std::lock_guard<std::mutex> lock(pose_mtx);
+  return frame_renderer;
+}
 
-  shader->bind();
-  shader->setUniform("model_matrix", model_matrix);
+Eigen::AlignedBox3f Pose::glBounds() {
+  return gl::transformBox(geometry()->glBounds(), poseMatrix());
+}
 
-  if (type == VisualType::AXIS)
-    shader->setColorMode(ColorMode::RGB);
-  else {
-    shader->setColorMode(ColorMode::UNIFORM);
-    shader->setUniform("uniform_color", color.asEigenVector4f());
-  }
+uint64_t Pose::glSortKey() {
+  const ColorMode mode =
+      type == VisualType::AXIS ? ColorMode::RGB : ColorMode::UNIFORM;
+  return sortKeyOf(geometry().get(), gl::ShaderVariant(mode), color,
+                   line_width);
+}
+
+bool Pose::glInstance(Instance& instance) {
+  instance.geometry = geometry().get();  // the cache keeps it alive
+  std::memcpy(&instance.state, &line_width, sizeof(line_width));
+  instance.transform = model_matrix * poseMatrix();
+  instance.color = color;
+  return true;
+}
+
+void Pose::glDrawInstances(const gl::StreamBuffer& instances, size_t count) {
+  bindState(Eigen::Matrix4f::Identity(), true);
+  geometry()->drawInstanced(instances, count);
+}
+
+void Pose::drawImpl() {
+  bindState(model_matrix * poseMatrix(), false);
+  if (type == VisualType::CAMERA_FRAME)
+    shader->setUniform(gl::Uniform::UNIFORM_COLOR, color.asEigenVector4f());
 
-  glLineWidth(line_width);
-  pimpl->draw(shader);
+  geometry()->draw();
+}
+
+void Pose::bindState(const Eigen::Matrix4f& matrix, bool instanced) {
+  gl::RenderState& state = gl::RenderState::getInstance();
+  state.setDepthTest(true, GL_LESS);
+
+  // the axis is colored per vertex, the camera frame per instance.
+  if (type == VisualType::AXIS)
+    shader->bind(gl::ShaderVariant(ColorMode::RGB,
+                                   instanced ? gl::SHADER_INSTANCED
+                                             : gl::SHADER_NONE));
+  else
+    shader->bind(gl::ShaderVariant(
+        ColorMode::UNIFORM,
+        instanced ? gl::SHADER_INSTANCED | gl::SHADER_INSTANCE_COLOR : 0));
+  shader->setModelMatrix(matrix);
+  state.setLineWidth(line_width);
 }
 
 }  // namespace object
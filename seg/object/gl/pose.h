@@ -1,8 +1,8 @@
 #pragma once
 
+#include <cstdint>
+#include <memory>
 #include <mutex>
-#include <tuple>
-#include <vector>
 
 #include <Eigen/Dense>
 
@@ -21,7 +21,13 @@ class Pose : public GLObject {
  public:
   Pose();
   Pose(const Eigen::Matrix4f pose);
+  ~Pose() override;
   const std::string getType() const override { return "Pose"; }
+  uint64_t glSortKey() override;
+
+  bool glInstance(Instance& instance) override;
+  void glDrawInstances(const gl::StreamBuffer& instances,
+                       size_t count) override;
 
   void setCameraParameters(float width, float height, float focal_length);
   void setCameraParameters(
@@ -41,16 +47,23 @@ class Pose : public GLObject {
  private:
   void drawImpl() override;
   void drawInspector();
+  Eigen::AlignedBox3f glBounds() override;
+  // pose within the object transform, scaled
+  Eigen::Matrix4f poseMatrix();
+  // of the current visual type
+  std::shared_ptr<gl::GeneralRenderer> geometry();
+  void bindState(const Eigen::Matrix4f& matrix, bool instanced);
 
   RGBA color = RGBA(0.0f, 0.0f, 0.0f, 1.0f);
 
   Eigen::Matrix4f pose = Eigen::Matrix4f::Identity();
   VisualType type = VisualType::AXIS;
-  VisualType prev = VisualType::AXIS;
 
   std::mutex pose_mtx;
-  std::vector<Eigen::Vector3f> camera_frame;
-  std::tuple<std::vector<Eigen::Vector3f>, std::vector<Eigen::Vector3f>> axis;
+
+  // axis lives in pimpl (position + color), camera frame is position only.
+  // both from gl::GeometryCache, shared by every pose alike.
+  std::shared_ptr<gl::GeneralRenderer> frame_renderer;  // under pose_mtx
 
 };  // class Path
 
@@ -0,0 +1,181 @@
+#include "seg/object/gl/scan_map.h"
+
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include <GL/glew.h>
+#include <imgui.h>
+
+#include "seg/gl/general_renderer.h"
+#include "seg/gl/instance_buffer.h"
+#include "seg/gl/render_state.h"
+#include "seg/gl/shader.h"
+#include "seg/ui/general_inspector.h"
+#include "seg/internal/logger.h"
+
+namespace seg {
+namespace object {
+ScanMap::ScanMap() {
+  pimpl.reset(new gl::Renderer<gl::layout::IndexedPositionScalar>(
+      gl::GeneralRenderer::BufferType::DYNAMIC,
+      gl::GeneralRenderer::RenderTarget::POINT));
+  pimpl->setLatency(&latency);
+  // a buffer texture is attached whole, the table must not move in a ring.
+  poses.reset(new gl::InstanceBuffer(UploadPolicy::ORPHAN));
+
+  inspector = ui::GeneralInspector::Builder()
+                  .addField("Scans", &num_scan)
+                  .addField("Points", &pimpl->vertexCount())
+                  .addDrawFunction([this] { drawInspector(); })
+                  .build();
+}
+
+// complete gl types for the unique_ptrs.
+ScanMap::~ScanMap() {}
+
+void ScanMap::glFree() {
+  pimpl->glFree();
+  poses->glFree();
+
+  if (pose_texture != 0) glDeleteTextures(1, &pose_texture);
+  pose_texture = 0;
+  attached_poses = 0;
+}
+
+size_t ScanMap::addScan(const Eigen::Matrix4f& pose,
+                        const AttributeView& points,
+                        const AttributeView& intensities) {
+  if ((points.count != 0 && points.data == nullptr) ||
+      (intensities.empty() == false && intensities.count != points.count)) {
+    LOG_ERROR("ScanMap - {} intensities for {} points!", intensities.count,
+              points.count);
+    throw std::invalid_argument("Invalid scan given!");
+  }
+
+  std::lock_guard<std::mutex> lock(scan_mtx);
+  const size_t index = num_scan;
+
+  // pose first, the gl thread takes them in reverse: points, then poses. so
+  // any points it has taken find their entry.
+  poses->add(CompactPose(pose));
+  pimpl->addData(points, intensities, static_cast<uint32_t>(index));
+
+  if (intensities.empty() == false) has_intensity = true;
+  num_scan++;
+  return index;
+}
+
+void ScanMap::updateScanPoses(const std::vector<size_t>& indices,
+                              const std::vector<Eigen::Matrix4f>& _poses) {
+  if (indices.size() != _poses.size()) {
+    LOG_ERROR("ScanMap - updateScanPoses size mismatch!");
+    throw std::invalid_argument("Indices and poses differ in size!");
+  }
+
+  std::vector<CompactPose> compact(_poses.begin(), _poses.end());
+
+  std::lock_guard<std::mutex> lock(scan_mtx);
+  for (const size_t index : indices) {
+    if (index >= num_scan) {
+      LOG_ERROR("ScanMap - Scan index {} out of range!", index);
+      throw std::invalid_argument("Scan index out of range given!");
+    }
+  }
+  poses->update(indices, compact);
+  latency.stamp();
+}
+
+void ScanMap::updateScanPoseRange(size_t first,
+                                  const std::vector<Eigen::Matrix4f>& _poses) {
+  std::vector<CompactPose> compact(_poses.begin(), _poses.end());
+
+  std::lock_guard<std::mutex> lock(scan_mtx);
+  if (first + compact.size() > num_scan) {
+    LOG_ERROR("ScanMap - Scan range [{}, {}) out of range!", first,
+              first + compact.size());
+    throw std::invalid_argument("Scan range out of range given!");
+  }
+  poses->update(first, compact);
+  latency.stamp();
+}
+
+void ScanMap::glBindPoseTable() {
+  if (pose_texture == 0) glGenTextures(1, &pose_texture);
+
+  glActiveTexture(GL_TEXTURE0 + gl::TEXTURE_UNIT_POSE_TABLE);
+  glBindTexture(GL_TEXTURE_BUFFER, pose_texture);
+  // new storage when the table grows, rewritten contents follow by themselves
+  if (poses->id() != attached_poses) {
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, poses->id());
+    attached_poses = poses->id();
+  }
+  glActiveTexture(GL_TEXTURE0);
+}
+
+void ScanMap::drawImpl() {
+  // reverse of addScan(): points taken first were published after their
+  // poses, which are then taken as well.
+  pimpl->glUpdate();
+  poses->glUpdate();
+  if (poses->count() == 0) return;
+  glBindPoseTable();
+
+  gl::RenderState& state = gl::RenderState::getInstance();
+  state.setDepthTest(true, GL_LESS);
+
+  shader->bind(gl::ShaderVariant(color_mode, gl::SHADER_POSE_TABLE));
+  shader->setModelMatrix(model_matrix);
+  shader->setUniform(gl::Uniform::UNIFORM_COLOR, color.asEigenVector4f());
+  if (color_mode == ColorMode::ZAXIS) {
+    shader->setUniform(gl::Uniform::VISUALIZE_Z_MIN, visualize_z_min);
+    shader->setUniform(gl::Uniform::VISUALIZE_Z_MAX, visualize_z_max);
+  }
+
+  state.setPointSize(point_size);
+  pimpl->draw();
+}
+
+void ScanMap::drawInspector() {
+  static int color_edit_flag = 0;
+  color_edit_flag |= ImGuiColorEditFlags_NoAlpha;
+  color_edit_flag |= ImGuiColorEditFlags_NoSidePreview;
+  color_edit_flag |= ImGuiColorEditFlags_PickerHueBar;
+  color_edit_flag |= ImGuiColorEditFlags_DisplayRGB;
+
+  ImGui::SliderFloat("Point Size", &point_size, 1.0, 5.0, "%.1f");
+
+  if (ImGui::BeginCombo("Coloring", enumToCharP(color_mode))) {
+    if (ImGui::Selectable(enumToCharP(ColorMode::UNIFORM),
+                          color_mode == ColorMode::UNIFORM))
+      color_mode = ColorMode::UNIFORM;
+
+    if (has_intensity) {
+      if (ImGui::Selectable(enumToCharP(ColorMode::SCALAR),
+                            color_mode == ColorMode::SCALAR))
+        color_mode = ColorMode::SCALAR;
+    }
+
+    if (ImGui::Selectable(enumToCharP(ColorMode::ZAXIS),
+                          color_mode == ColorMode::ZAXIS))
+      color_mode = ColorMode::ZAXIS;
+
+    ImGui::EndCombo();
+  }
+
+  if (color_mode == ColorMode::UNIFORM) {
+    if (ImGui::TreeNode("Color Picker")) {
+      ImGui::ColorPicker3("##", (float*)&color, color_edit_flag);
+      ImGui::TreePop();
+    }
+  } else if (color_mode == ColorMode::ZAXIS) {
+    ImGui::SliderFloat("Z Min", &visualize_z_min, -30.0f, 0.0f,
+                       "min z = %.2f");
+    ImGui::SliderFloat("Z Max", &visualize_z_max, 0.0f, 200.0f,
+                       "max z = %.2f");
+  }
+}
+
+}  // namespace object
+}  // namespace seg
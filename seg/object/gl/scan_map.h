@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <Eigen/Dense>
+#include <GL/glew.h>
+
+#include "seg/attribute_view.h"
+#include "seg/object/gl_object.h"
+#include "seg/types.h"
+
+namespace seg {
+namespace gl {
+class InstanceBuffer;
+}  // namespace gl
+
+namespace object {
+/**
+ * Scans kept on the gpu in sensor frame, each placed by its own pose, e.g.
+ * the keyframes of a SLAM map. Poses live in a pose table the vertex shader
+ * reads, so re-optimizing them rewrites 32 B per scan instead of the points,
+ * and the whole map is a single draw call.
+ */
+class ScanMap : public GLObject {
+ public:
+  ScanMap();
+  ~ScanMap() override;
+  const std::string getType() const override { return "Scan Map"; }
+
+  void glFree() override;
+
+  void setColor(const RGBA& _color) { color = _color; }
+  void setPointSize(float _point_size) { point_size = _point_size; }
+
+  /**
+   * @brief Appends a scan, points in sensor frame. Only the new points are
+   *        uploaded.
+   * @return index of the scan, for updateScanPoses().
+   * @throw std::invalid_argument on intensities not matching the points.
+   */
+  size_t addScan(const Eigen::Matrix4f& pose,
+                 const AttributeView& points,
+                 const AttributeView& intensities = AttributeView());
+
+  /**
+   * @brief Moves existing scans, e.g. after a loop closure. Only the pose
+   *        table is uploaded, points stay untouched.
+   * @throw std::invalid_argument on size mismatch or indices past the count.
+   */
+  void updateScanPoses(const std::vector<size_t>& indices,
+                       const std::vector<Eigen::Matrix4f>& poses);
+  void updateScanPoseRange(size_t first,
+                           const std::vector<Eigen::Matrix4f>& poses);
+
+  size_t scanCount() const { return num_scan; }
+
+ private:
+  void drawImpl() override;
+  void drawInspector();
+  void glBindPoseTable();
+  // scans move with the pose table, the map is never culled.
+  Eigen::AlignedBox3f glBounds() override { return Eigen::AlignedBox3f(); }
+
+  ColorMode color_mode = ColorMode::UNIFORM;
+  RGBA color = RGBA(0.0f, 0.0f, 0.0f, 1.0f);
+  float point_size = 2.0f;
+
+  float visualize_z_min = -10.0f;
+  float visualize_z_max = 30.0f;
+
+  // producer side, keeps scan indices and pose table entries in step.
+  std::mutex scan_mtx;
+  std::atomic<size_t> num_scan{0};  // also read unlocked
+  std::atomic<bool> has_intensity{false};
+
+  // pose table, sampled as a buffer texture of 2 RGBA32F texels per pose.
+  std::unique_ptr<gl::InstanceBuffer> poses;
+  GLuint pose_texture = 0;   // gl thread
+  GLuint attached_poses = 0;  // buffer behind pose_texture
+
+};  // class ScanMap
+}  // namespace object
+}  // namespace seg
@@ -1,6 +1,15 @@
 #include "seg/object/gl_object.h"
 
+#include <array>
+#include <cstdint>
+
+#include <Eigen/Dense>
+
+#include "seg/core/frame_request.h"
 #include "seg/gl/general_renderer.h"
+#include "seg/gl/render_state.h"
+#include "seg/gl/shader.h"
+#include "seg/gl/view.h"
 
 namespace seg {
 namespace object {
@@ -11,7 +20,71 @@ GLObject::GLObject() {}
 GLObject::~GLObject() {}
 
 void GLObject::glFree() {
-  if (pimpl) pimpl->glFree();
+  if (pimpl && shared_geometry == false) pimpl->glFree();
+}
+
+void GLObject::setTransform(const Eigen::Matrix4f& _transform) {
+  std::array<float, 16> values;
+  Eigen::Map<Eigen::Matrix4f>(values.data()) = _transform;
+  transform.store(values);
+  latency.stamp();
+  FrameRequest::request();
+}
+
+Eigen::Matrix4f GLObject::getTransform() const {
+  if (transform.version() == 0) return Eigen::Matrix4f::Identity();
+
+  const std::array<float, 16> values = transform.load();
+  return Eigen::Map<const Eigen::Matrix4f>(values.data());
+}
+
+void GLObject::glUpdateTransform() {
+  const uint32_t version = transform.version();
+  if (version == applied_transform) return;  // usual case, one atomic load
+
+  const std::array<float, 16> values = transform.load();
+  model_matrix = Eigen::Map<const Eigen::Matrix4f>(values.data());
+  applied_transform = version;
+}
+
+Eigen::AlignedBox3f GLObject::glBounds() {
+  return pimpl ? pimpl->glBounds() : Eigen::AlignedBox3f();
+}
+
+uint64_t GLObject::glSortKey() {
+  const RGBA opaque(0.0f, 0.0f, 0.0f, 1.0f);
+  return sortKeyOf(pimpl.get(), gl::ShaderVariant(), opaque, 0.0f);
+}
+
+uint64_t GLObject::sortKeyOf(const gl::GeneralRenderer* geometry,
+                             const gl::ShaderVariant& variant,
+                             const RGBA& color,
+                             float size) const {
+  if (geometry == nullptr) return 0;
+  const auto primitive = static_cast<GLenum>(geometry->getRenderTarget());
+  // translucent if alpha comes from the vertices, or a uniform color below 1
+  const bool blend =
+      variant.color_mode == ColorMode::RGBA ||
+      (variant.color_mode == ColorMode::UNIFORM && color.a < 1.0f);
+  return gl::makeSortKey(blend, variant.key(), primitive, size, geometry);
+}
+
+bool GLObject::glIsCulled() {
+  if (view == nullptr) return false;
+
+  const Eigen::AlignedBox3f box = glBounds();
+
+  const float max_distance = max_draw_distance;
+  if (max_distance > 0.0f) {
+    const float distance =
+        box.isEmpty()
+            ? (model_matrix.block<3, 1>(0, 3) - view->eye).norm()
+            : gl::transformBox(box, model_matrix).exteriorDistance(view->eye);
+    if (distance > max_distance) return true;
+  }
+
+  if (box.isEmpty()) return false;
+  return view->intersects(box, model_matrix) == false;
 }
 
 }  // namespace object
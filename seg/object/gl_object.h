@@ -1,15 +1,23 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <memory>
 
 #include <Eigen/Dense>
 
+#include "seg/internal/seqlock.h"
 #include "seg/object/object_base.h"
+#include "seg/types.h"
 
 namespace seg {
 namespace gl {
 class Shader;
+struct ShaderVariant;
 class GeneralRenderer;
+class StreamBuffer;
+struct View;
 }  // namespace gl
 
 namespace object {
@@ -20,14 +28,92 @@ class GLObject : public ObjectBase {
 
   virtual void glFree();
   virtual void setShader(gl::Shader* _shader) { shader = _shader; }
+  void setView(const gl::View* _view) { view = _view; }
+
+  /**
+   * @brief Places the object in the world, from any thread without locks.
+   *        Geometry stays resident on the gpu; the next frame draws with the
+   *        latest transform.
+   */
+  void setTransform(const Eigen::Isometry3f& transform) {
+    setTransform(transform.matrix());
+  }
+  void setTransform(const Eigen::Matrix4f& transform);
+  Eigen::Matrix4f getTransform() const;
+
+  // gl thread: takes the latest setTransform() into model_matrix.
+  void glUpdateTransform();
+
+  /**
+   * @brief Objects farther than distance (world units, from the camera to
+   *        their bounds) are not drawn. 0 - unlimited.
+   */
+  void setMaxDrawDistance(float distance) { max_draw_distance = distance; }
+  float getMaxDrawDistance() const { return max_draw_distance; }
+
+  /**
+   * @brief gl thread: whether this frame can skip the object, outside of the
+   *        view frustum or beyond the max draw distance.
+   */
+  bool glIsCulled();
+
+  /**
+   * @brief gl thread: draw order within a frame. ObjectManager draws in
+   *        ascending keys, so objects sharing gl state draw back to back.
+   *        default - an opaque uniform color draw of pimpl.
+   */
+  virtual uint64_t glSortKey();
+
+  /**
+   * One draw of shared geometry, which ObjectManager batches with others of
+   * the same type, geometry and state into an instanced draw.
+   */
+  struct Instance {
+    const gl::GeneralRenderer* geometry = nullptr;
+    uint64_t state = 0;  // equal -> the draws differ in transform and color
+    Eigen::Matrix4f transform = Eigen::Matrix4f::Identity();  // world
+    RGBA color;
+  };
+  // gl thread: false if the object does not draw as an instance this frame.
+  virtual bool glInstance(Instance& /*instance*/) { return false; }
+  /**
+   * @brief gl thread: draws count gl::InstanceAttributes of the group the
+   *        object is first of, with its state.
+   */
+  virtual void glDrawInstances(const gl::StreamBuffer& /*instances*/,
+                               size_t /*count*/) {}
 
   ObjectLayer getObjectLayer() const override { return ObjectLayer::GL; }
 
  protected:
+  /**
+   * gl thread: box around everything drawImpl() draws, before model_matrix.
+   * Of the newest data, so culling never holds back an update moving the
+   * object into view. Empty if unknown, such objects are never culled.
+   */
+  virtual Eigen::AlignedBox3f glBounds();
+
+  /**
+   * gl::makeSortKey() of a draw of geometry with variant, blended by the
+   * alpha of color / RGBA vertices. size - line width / point size
+   */
+  uint64_t sortKeyOf(const gl::GeneralRenderer* geometry,
+                     const gl::ShaderVariant& variant,
+                     const RGBA& color,
+                     float size) const;
+
   gl::Shader* shader = nullptr;
-  Eigen::Matrix4f model_matrix = Eigen::Matrix4f::Identity();
+  const gl::View* view = nullptr;  // current frame, for view dependent lod
+  Eigen::Matrix4f model_matrix = Eigen::Matrix4f::Identity();  // gl thread
+
+  std::shared_ptr<gl::GeneralRenderer> pimpl;
+  // pimpl from gl::GeometryCache, which frees it once unused.
+  bool shared_geometry = false;
 
-  std::unique_ptr<gl::GeneralRenderer> pimpl;
+ private:
+  SeqLock<std::array<float, 16>> transform;  // column major
+  uint32_t applied_transform = 0;            // version in model_matrix
+  std::atomic<float> max_draw_distance{0.0f};
 
 };  // class GLObject
 }  // namespace object
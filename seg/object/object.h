@@ -3,8 +3,10 @@
 #include <memory>
 
 #include "seg/object/gl/basic_renderers.h"
+#include "seg/object/gl/octree_pointcloud.h"
 #include "seg/object/gl/path.h"
 #include "seg/object/gl/pose.h"
+#include "seg/object/gl/scan_map.h"
 #include "seg/object/primitives.h"
 #include "seg/object/ui/image.h"
 
@@ -1,5 +1,6 @@
 #include "seg/object/object_base.h"
 
+#include "seg/core/frame_request.h"
 #include "seg/ui/general_inspector.h"
 
 namespace seg {
@@ -8,5 +9,10 @@ namespace object {
 ObjectBase::ObjectBase() = default;
 ObjectBase::~ObjectBase() = default;
 
+void ObjectBase::setVisible(bool visible) {
+  is_visible = visible;
+  FrameRequest::request();
+}
+
 }  // namespace object
 }  // namespace seg
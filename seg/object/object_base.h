@@ -3,6 +3,8 @@
 #include <memory>
 #include <string>
 
+#include "seg/core/data_latency.h"
+
 namespace seg {
 namespace ui {
 class GeneralInspector;
@@ -24,9 +26,16 @@ class ObjectBase {
   virtual ObjectLayer getObjectLayer() const = 0;
   virtual const std::string getType() const = 0;
 
+  // unlike writing is_visible, also wakes a RenderMode::ON_DEMAND loop.
+  void setVisible(bool visible);
+
   bool is_visible = true;
   std::unique_ptr<ui::GeneralInspector> inspector;
 
+  // of changes to what it shows. (setData, transforms ...)
+  DataLatencyStats getDataLatency() { return latency.snapshot(); }
+  core::DataLatency latency;  // stamped by producers, latched by rendering
+
  private:
   // Uncopyable
   ObjectBase(const ObjectBase&) = delete;
@@ -6,6 +6,7 @@
 #include <GLFW/glfw3.h>
 #include <imgui.h>
 
+#include "seg/core/frame_request.h"
 #include "seg/ui/general_inspector.h"
 #include "seg/internal/logger.h"
 
@@ -102,6 +103,8 @@ void Image::setData(cv::Mat&& image) {
   auto lock = std::unique_lock<std::mutex>(mtx);
   image_buffer = std::move(image);  // cv::Mat supports move scemantic
   updated.store(true);
+  latency.stamp();
+  FrameRequest::request();
 }
 
 void Image::setData(const cv::Mat& image) { setData(image.clone()); }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <string>
+
 #include "seg/types.h"
 
 namespace seg {
@@ -19,6 +21,41 @@ enum class Theme {
   LIGHT,
 };
 
+/**
+ * How DYNAMIC renderers push vertex data to the GPU.
+ * AUTO picks PERSISTENT_RING when the GL driver supports buffer storage
+ * (GL 4.4 / ARB_buffer_storage), ORPHAN otherwise.
+ */
+enum class UploadPolicy {
+  AUTO,
+  REALLOCATE,       // glBufferData on every update (legacy)
+  ORPHAN,           // reuse storage, orphan + glBufferSubData
+  PERSISTENT_RING,  // persistently mapped multi-slot ring, fenced
+};
+
+/**
+ * When the SEG thread draws.
+ * ON_DEMAND sleeps until something changes what a frame would show: object
+ * data, transforms or visibility (ObjectBase::setVisible), objects added or
+ * removed, or input on the window. An idle scene then costs no cpu / gpu.
+ */
+enum class RenderMode {
+  CONTINUOUS,  // every vsync
+  ON_DEMAND,
+};
+
+/**
+ * How frames are paced.
+ * LOW_LATENCY trades smoothness for the delay from setData() to pixels:
+ * vsync off with an optional frame cap, object data latched as late as the
+ * cap allows, and optionally a fence wait after each swap, so no frames
+ * queue up in the driver. (see FrameStats::latency_ms)
+ */
+enum class FramePacing {
+  VSYNC,
+  LOW_LATENCY,
+};
+
 typedef int LogFlag;
 enum _LogFlag {
   LOG_NONE = 0,
@@ -35,6 +72,18 @@ struct Options {
   Verbosity verbosity = Verbosity::INFO;
   Theme theme = Theme::LIGHT;
   LogFlag log_flag = 1;  // TODO: implement log flag configuration
+  UploadPolicy upload_policy = UploadPolicy::AUTO;
+  RenderMode render_mode = RenderMode::CONTINUOUS;
+  FramePacing frame_pacing = FramePacing::VSYNC;
+  int frame_cap = 0;     // LOW_LATENCY, frames per second. 0 - uncapped
+  bool gpu_sync = true;  // LOW_LATENCY, wait for the gpu after each swap
+  // profiler window, frames slower than this are kept as hitches.
+  float frame_budget_ms = 33.3f;
+
+  // linked shader programs kept on disk, so later starts skip compiling.
+  // empty dir: $XDG_CACHE_HOME/seg/shaders, or ~/.cache/seg/shaders.
+  bool use_shader_cache = true;
+  std::string shader_cache_dir = "";
 };
 
 }  // namespace seg
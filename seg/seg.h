@@ -5,8 +5,11 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "seg/batch.h"
 #include "seg/options.h"
+#include "seg/stats.h"
 #include "seg/types.h"
 
 namespace seg {
@@ -26,35 +29,61 @@ void initialize(const std::string& window_name = "",
 /**
  * @brief Adds object to SEG.
  *        This Objects will be managed inside SEG.
- * @param name name to be displayed. If not given, SEG will generate one for
- * you.
+ * @param name unique name to be displayed and looked up by. If not given,
+ * the object is displayed as "<type> #<slot>".
  * @param object Raw or shared ptr of class derived from ObjectBase.
  *               Shared_ptr is recommended when you want to access it
  * thereafter.
+ * @return handle of the object, invalid if the name is already taken.
  */
-void addObject(const std::string& name,
-               const std::shared_ptr<object::ObjectBase>& object);
+ObjectHandle addObject(const std::string& name,
+                       const std::shared_ptr<object::ObjectBase>& object);
 
 /** @overload
  */
-void addObject(const std::string& name, object::ObjectBase* object);
+ObjectHandle addObject(const std::string& name, object::ObjectBase* object);
 
 /** @overload
- *  @return name made by seg.
  */
-std::string addObject(const std::shared_ptr<object::ObjectBase>& object);
+ObjectHandle addObject(const std::shared_ptr<object::ObjectBase>& object);
 
 /** @overload
- *  @return name made by seg.
  */
-std::string addObject(object::ObjectBase* object);
+ObjectHandle addObject(object::ObjectBase* object);
 
 /**
- * @brief Deletes object with name.
- * @return True if deleted, false otherwise. (No object with given name)
+ * @brief Deletes object.
+ * @return True if deleted, false otherwise. (stale handle)
+ */
+bool deleteObject(ObjectHandle handle);
+
+/** @overload
+ *  @return True if deleted, false otherwise. (No object with given name)
  */
 bool deleteObject(const std::string& name);
 
+/**
+ * @brief Applies every change staged in batch at one frame boundary, so no
+ *        frame shows part of it. Takes one lock for the whole batch.
+ * @return handles of the staged adds in order, invalid where one failed.
+ */
+std::vector<ObjectHandle> commit(Batch&& batch);
+
+/**
+ * @brief Returns rendering statistics. (frame times, gpu uploads)
+ *        Safe to call from any thread.
+ */
+FrameStats getFrameStats();
+
+/**
+ * @brief Returns how long changes to one object (setData, transforms,
+ *        Path::addPose ...) took to reach the screen, p50 / p95 / p99 over
+ *        its recent changes. Every object together is in
+ *        FrameStats::data_latency. Safe to call from any thread.
+ * @return empty stats for a stale handle.
+ */
+DataLatencyStats getDataLatency(ObjectHandle handle);
+
 /**
  * @brief Starts the rendering loop on the calling thread (blocking).
  *        In MAIN_THREAD mode, call this after initialize() and addObject().
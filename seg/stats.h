@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+
+namespace seg {
+struct LatencyPercentiles {
+  double p50_ms = 0.0;
+  double p95_ms = 0.0;
+  double p99_ms = 0.0;
+};
+
+/**
+ * Age of object changes (setData, transforms, Path::addPose ...) when the
+ * render thread took them for upload, and when their frame was on screen,
+ * over the most recent changes. "On screen" is the gpu finishing the frame
+ * with Options::gpu_sync in LOW_LATENCY, the swap returning otherwise.
+ */
+struct DataLatencyStats {
+  uint64_t count = 0;  // changes measured since initialize()
+  LatencyPercentiles to_upload;
+  LatencyPercentiles to_present;
+};
+
+/**
+ * Rendering statistics, sampled from the SEG thread.
+ * Counters are cumulative since initialize(); frame times are taken over the
+ * most recent frames.
+ */
+struct FrameStats {
+  uint64_t frame_count = 0;
+  double frame_time_ms = 0.0;  // last frame interval (swap to swap)
+  double frame_time_mean_ms = 0.0;
+  double frame_time_stddev_ms = 0.0;
+
+  uint64_t upload_bytes = 0;    // vertex / index bytes sent to the GPU
+  double upload_time_ms = 0.0;  // cpu time spent issuing uploads
+  uint64_t upload_stalls = 0;   // uploads that had to wait on the GPU
+
+  // visible objects of the last frame, by whether they were drawn
+  uint64_t objects_drawn = 0;
+  uint64_t objects_culled = 0;  // outside the frustum / max draw distance
+
+  // gl work of the last frame, scene and objects (not the ui)
+  uint64_t draw_calls = 0;
+  uint64_t state_changes = 0;  // program / depth / blend / line / point size
+
+  // object data latched -> frame on screen. the gpu finishing the frame with
+  // Options::gpu_sync, the swap returning otherwise.
+  double latency_ms = 0.0;  // last frame
+  double latency_mean_ms = 0.0;
+
+  DataLatencyStats data_latency;  // of every object
+
+  // startup: window creation to the first frame on screen, and how the
+  // shader programs of that start were made (see Options::use_shader_cache)
+  double first_frame_ms = 0.0;
+  uint64_t programs_cached = 0;
+  uint64_t programs_compiled = 0;
+};
+
+}  // namespace seg
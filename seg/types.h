@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 #include <Eigen/Dense>
 
 namespace seg {
@@ -24,6 +26,23 @@ struct RGBA {
   }
 };
 
+/**
+ * Handle of an object added to SEG. Once the object is deleted the handle
+ * stays invalid, even after its slot is reused.
+ */
+struct ObjectHandle {
+  uint32_t index = 0;
+  uint32_t generation = 0;  // 0 -> null handle
+
+  bool valid() const { return generation != 0; }
+  bool operator==(const ObjectHandle& other) const {
+    return index == other.index && generation == other.generation;
+  }
+  bool operator!=(const ObjectHandle& other) const {
+    return !(*this == other);
+  }
+};
+
 struct Position {
   int x;
   int y;
@@ -43,6 +62,27 @@ struct Triangle {
   unsigned int vertex_index[3];
 };
 
+/**
+ * Rigid pose as quaternion + translation. 32 B, half of an Eigen::Matrix4f.
+ */
+struct CompactPose {
+  float rotation[4];     // quaternion x, y, z, w
+  float translation[4];  // x, y, z, (padding)
+
+  CompactPose() : rotation{0, 0, 0, 1}, translation{0, 0, 0, 0} {}
+  CompactPose(const Eigen::Matrix4f& pose) {
+    const Eigen::Quaternionf q(pose.block<3, 3>(0, 0));
+    const Eigen::Vector4f coeffs = q.normalized().coeffs();  // x y z w
+    for (int k = 0; k < 4; k++) rotation[k] = coeffs[k];
+    for (int k = 0; k < 3; k++) translation[k] = pose(k, 3);
+    translation[3] = 0.0f;
+  }
+
+  inline Eigen::Vector3f position() const {
+    return Eigen::Vector3f(translation[0], translation[1], translation[2]);
+  }
+};
+
 // 2D ==============================================
 typedef WindowSize ImageSize;
 
@@ -61,6 +101,20 @@ enum class ColorMode {
   ZAXIS = 4,
 };
 
+/**
+ * GPU storage format of vertex attributes.
+ * FLOAT     - 32 bit float position / color / scalar. (28 B per point)
+ * COMPACT16 - int16 position quantized per spatial chunk, uint8 color,
+ *             half float scalar. (8 - 12 B per point)
+ * COMPACT8  - as COMPACT16, with uint8 scalar.
+ * Compact scalars keep the visualized 0 - 255 range only.
+ */
+enum class VertexFormat {
+  FLOAT,
+  COMPACT16,
+  COMPACT8,
+};
+
 inline const char* enumToCharP(ColorMode mode) {
   static const char* names[] = {"Uniform", "RGB", "RGBA", "Scalar", "Z-Axis"};
   return names[static_cast<int>(mode)];
@@ -11,6 +11,7 @@
 #include "seg/ui/main_menu.h"
 #include "seg/ui/object_inspector_window.h"
 #include "seg/ui/object_list_window.h"
+#include "seg/ui/profiler_window.h"
 #include "seg/internal/logger.h"
 
 namespace seg {
@@ -31,6 +32,7 @@ void Controller::init(gl::Scene* _scene,
       std::move(std::unique_ptr<ObjectListWindow>(obj_list)));
   base_objects.push_back(
       std::move(std::unique_ptr<ObjectInspectorWindow>(obj_inspector)));
+  base_objects.emplace_back(std::make_unique<ProfilerWindow>());
 }
 
 void Controller::drawUI() {
@@ -3,6 +3,7 @@
 #include <imgui.h>
 
 #include "seg/core/config.h"
+#include "seg/core/stats.h"
 #include "seg/internal/logger.h"
 
 namespace seg {
@@ -40,6 +41,19 @@ void FpsOverlay::drawImpl() {
   ImGui::Begin(" ", nullptr, window_flag);
   ImGui::TextColored(ImVec4(0.9f, 0.9f, 0.9f, 0.9f), "FPS : %.1f",
                      io.Framerate);
+  if (getConfig().show_render_stats) {
+    const FrameStats stats = core::Stats::getInstance().snapshot();
+    ImGui::TextColored(ImVec4(0.9f, 0.9f, 0.9f, 0.9f),
+                       "Draws : %llu  States : %llu",
+                       static_cast<unsigned long long>(stats.draw_calls),
+                       static_cast<unsigned long long>(stats.state_changes));
+    ImGui::TextColored(ImVec4(0.9f, 0.9f, 0.9f, 0.9f), "Latency : %.1f ms",
+                       stats.latency_mean_ms);
+    const LatencyPercentiles& data = stats.data_latency.to_present;
+    ImGui::TextColored(ImVec4(0.9f, 0.9f, 0.9f, 0.9f),
+                       "Data : %.1f / %.1f / %.1f ms", data.p50_ms,
+                       data.p95_ms, data.p99_ms);
+  }
 
   ImGui::End();
   ImGui::PopStyleColor();
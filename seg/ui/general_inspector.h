@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <cstdio>
 #include <functional>
 #include <memory>
@@ -20,9 +21,17 @@ class GeneralInspector {
     std::function<std::string()> display;
   };
 
+  template <typename T>
+  struct IsAtomic : std::false_type {};
+  template <typename T>
+  struct IsAtomic<std::atomic<T>> : std::true_type {};
+
   template <typename T>
   static std::string format(T* pointer) {
-    if constexpr (std::is_same_v<T, bool>) {
+    if constexpr (IsAtomic<T>::value) {
+      auto value = pointer->load();
+      return format(&value);
+    } else if constexpr (std::is_same_v<T, bool>) {
       return *pointer ? "True" : "False";
     } else if constexpr (std::is_same_v<T, std::string>) {
       return *pointer;
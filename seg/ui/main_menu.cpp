@@ -79,10 +79,25 @@ void MainMenu::visualizeMenu() {
     ImGui::Text("Show");
     ImGui::Indent();
     ImGui::MenuItem("FPS", nullptr, &getConfig().show_fps);
+    ImGui::MenuItem("Render Stats", nullptr, &getConfig().show_render_stats);
     ImGui::MenuItem("Grid", nullptr, &getConfig().show_grid);
     ImGui::MenuItem("Origin Axis", nullptr, &getConfig().show_origin);
     ImGui::Unindent();
 
+    ImGui::Separator();  // -----------------
+
+    ImGui::Text("Rendering");
+    ImGui::Indent();
+    bool on_demand = getConfig().render_mode == RenderMode::ON_DEMAND;
+    if (ImGui::MenuItem("On Demand", nullptr, &on_demand))
+      getConfig().render_mode =
+          on_demand ? RenderMode::ON_DEMAND : RenderMode::CONTINUOUS;
+    bool low_latency = getConfig().frame_pacing == FramePacing::LOW_LATENCY;
+    if (ImGui::MenuItem("Low Latency", nullptr, &low_latency))
+      getConfig().frame_pacing =
+          low_latency ? FramePacing::LOW_LATENCY : FramePacing::VSYNC;
+    ImGui::Unindent();
+
     ImGui::EndMenu();
   }
 }
@@ -95,6 +110,8 @@ void MainMenu::windowMenu() {
 
     ImGui::MenuItem("Inspector", nullptr, show_object_inspector);
 
+    ImGui::MenuItem("Profiler", nullptr, &getConfig().show_profiler);
+
     ImGui::EndMenu();
   }
 }
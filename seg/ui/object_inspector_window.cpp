@@ -20,14 +20,25 @@ void ObjectInspectorWindow::drawImpl() {
   ImGui::PushStyleVar(ImGuiStyleVar_WindowMinSize, ImVec2(200, 200));
   ImGui::Begin("Inspector", nullptr, window_flag);
 
-  auto& name = getConfig().selected_object_name;
-  if (!name.empty()) {
-    auto obj = object_manager->getObject(name).lock();
-    if (obj) {
-      ImGui::TextUnformatted(name.c_str());
-      ImGui::Separator();
-      ImGui::TextUnformatted(("Type : " + obj->getType()).c_str());
-      if (obj->inspector) obj->inspector->draw();
+  std::string name;
+  auto obj = object_manager->findObject(getConfig().selected_object, &name);
+  if (obj) {
+    ImGui::TextUnformatted(name.c_str());
+    ImGui::Separator();
+    ImGui::TextUnformatted(("Type : " + obj->getType()).c_str());
+    if (obj->inspector) obj->inspector->draw();
+
+    const DataLatencyStats latency = obj->getDataLatency();
+    if (latency.count != 0 && ImGui::TreeNode("Latency")) {
+      ImGui::Text("Updates : %llu",
+                  static_cast<unsigned long long>(latency.count));
+      ImGui::Text("To upload  p50 %.1f  p95 %.1f  p99 %.1f ms",
+                  latency.to_upload.p50_ms, latency.to_upload.p95_ms,
+                  latency.to_upload.p99_ms);
+      ImGui::Text("To present p50 %.1f  p95 %.1f  p99 %.1f ms",
+                  latency.to_present.p50_ms, latency.to_present.p95_ms,
+                  latency.to_present.p99_ms);
+      ImGui::TreePop();
     }
   }
 
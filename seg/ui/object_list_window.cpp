@@ -19,17 +19,24 @@ void ObjectListWindow::drawImpl() {
 
   ImGui::Begin("Objects", nullptr, window_flag);
 
-  int i = -1;  // to resolve id collision
-  object_manager->forEachObject([&](const std::string& name, object::ObjectBase& obj) {
-    i++;
-    const bool is_selected = (name == getConfig().selected_object_name);
-    ImGui::Checkbox((std::string("##") + std::to_string(i)).c_str(),
-                    &obj.is_visible);
-    ImGui::SameLine();
-    if (ImGui::Selectable(name.c_str(), is_selected)) {
-      getConfig().selected_object_name = name;
-    }
-  });
+  // only the visible rows are built, lists of 100k objects stay cheap.
+  ImGuiListClipper clipper;
+  clipper.Begin(static_cast<int>(object_manager->objectCount()));
+  while (clipper.Step()) {
+    int i = clipper.DisplayStart;  // to resolve id collision
+    object_manager->forEachObject(
+        clipper.DisplayStart, clipper.DisplayEnd,
+        [&](ObjectHandle handle, const std::string& name,
+            object::ObjectBase& obj) {
+          const bool is_selected = (handle == getConfig().selected_object);
+          ImGui::Checkbox((std::string("##") + std::to_string(i++)).c_str(),
+                          &obj.is_visible);
+          ImGui::SameLine();
+          if (ImGui::Selectable(name.c_str(), is_selected))
+            getConfig().selected_object = handle;
+        });
+  }
+  clipper.End();
 
   ImGui::End();
 
@@ -0,0 +1,101 @@
+#include "seg/ui/profiler_window.h"
+
+#include <array>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <imgui.h>
+
+#include "seg/core/config.h"
+#include "seg/core/profiler.h"
+
+namespace seg {
+namespace ui {
+namespace {
+void objectTable(const char* id,
+                 const std::vector<core::Profiler::ObjectTime>& times) {
+  if (!ImGui::BeginTable(id, 3,
+                         ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg |
+                             ImGuiTableFlags_SizingFixedFit))
+    return;
+
+  ImGui::TableSetupColumn("Object");
+  ImGui::TableSetupColumn("CPU ms");
+  ImGui::TableSetupColumn("GPU ms");
+  ImGui::TableHeadersRow();
+  for (const core::Profiler::ObjectTime& time : times) {
+    ImGui::TableNextRow();
+    ImGui::TableNextColumn();
+    ImGui::TextUnformatted(time.name.c_str());
+    ImGui::TableNextColumn();
+    ImGui::Text("%.3f", time.cpu_ms);
+    ImGui::TableNextColumn();
+    if (time.gpu_ms < 0.0)
+      ImGui::TextUnformatted("-");
+    else
+      ImGui::Text("%.3f", time.gpu_ms);
+  }
+  ImGui::EndTable();
+}
+
+void phaseList(const std::array<double, core::Profiler::PHASE_COUNT>& ms) {
+  for (int i = 0; i < core::Profiler::PHASE_COUNT; i++) {
+    const auto phase = static_cast<core::Profiler::Phase>(i);
+    ImGui::Text("%-8s %7.3f ms", core::Profiler::phaseName(phase), ms[i]);
+  }
+}
+}  // namespace
+
+ProfilerWindow::ProfilerWindow() {
+  window_flag |= ImGuiWindowFlags_NoCollapse;
+}
+
+void ProfilerWindow::drawImpl() {
+  core::Config& config = getConfig();
+  if (config.show_profiler == false) return;
+
+  core::Profiler& profiler = core::Profiler::getInstance();
+  ImGui::PushStyleVar(ImGuiStyleVar_WindowMinSize, ImVec2(300, 200));
+  ImGui::Begin("Profiler", &config.show_profiler, window_flag);
+
+  // frame times, scaled so the budget is half way up
+  ImGui::PlotLines("##frame_times", profiler.frameTimes(),
+                   core::Profiler::GRAPH_FRAMES, profiler.frameTimeOffset(),
+                   "frame ms", 0.0f, config.frame_budget_ms * 2.0f,
+                   ImVec2(-1.0f, 80.0f));
+  ImGui::SliderFloat("Budget (ms)", &config.frame_budget_ms, 4.0f, 100.0f,
+                     "%.1f");
+
+  if (ImGui::CollapsingHeader("Phases", ImGuiTreeNodeFlags_DefaultOpen))
+    phaseList(profiler.lastPhases());
+
+  if (ImGui::CollapsingHeader("Slowest Objects",
+                              ImGuiTreeNodeFlags_DefaultOpen))
+    objectTable("##slowest", profiler.slowestObjects(TOP_OBJECTS));
+
+  const auto& hitches = profiler.hitches();
+  const std::string hitch_header =
+      "Hitches (" + std::to_string(hitches.size()) + ")###hitches";
+  if (ImGui::CollapsingHeader(hitch_header.c_str())) {
+    if (ImGui::Button("Clear")) profiler.clearHitches();
+    // newest first
+    for (auto iter = hitches.rbegin(); iter != hitches.rend(); ++iter) {
+      char label[64];
+      std::snprintf(label, sizeof(label), "#%llu  %.1f ms",
+                    static_cast<unsigned long long>(iter->frame),
+                    iter->frame_ms);
+      if (ImGui::TreeNode(label)) {
+        phaseList(iter->phase_ms);
+        objectTable("##hitch_objects", iter->slowest);
+        ImGui::TreePop();
+      }
+    }
+  }
+
+  ImGui::End();
+  ImGui::PopStyleVar(1);
+}
+
+}  // namespace ui
+}  // namespace seg
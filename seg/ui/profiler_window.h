@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+
+#include "seg/object/ui_object.h"
+
+namespace seg {
+namespace ui {
+/**
+ * core::Profiler results: frame time graph, phases of the last frame, the
+ * slowest objects and the hitches. Shown while Config::show_profiler.
+ */
+class ProfilerWindow : public object::UIObject {
+ public:
+  ProfilerWindow();
+  ProfilerWindow(const ProfilerWindow&) = delete;
+  ProfilerWindow& operator=(const ProfilerWindow&) = delete;
+
+  const std::string getType() const override { return "Profiler Window"; }
+
+ private:
+  static const int TOP_OBJECTS = 10;
+
+  void drawImpl() override;
+
+};  // class ProfilerWindow
+}  // namespace ui
+}  // namespace seg